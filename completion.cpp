@@ -0,0 +1,210 @@
+#include "completion.hpp"
+#include <algorithm>
+#include <cctype>
+#include <tuple>
+
+using namespace lsp;
+
+// prefix matches always rank above fuzzy ones
+static const int PREFIX_SCORE = 1000;
+
+static std::string fold(std::string_view str) {
+  std::string folded(str);
+  for (char& c : folded) {
+    c = std::tolower((unsigned char)c);
+  }
+  return folded;
+}
+
+static bool is_word_char(char c) {
+  return std::isalnum((unsigned char)c) || c == '_' || c == '$';
+}
+
+CompletionEngine::CompletionEngine(std::span<const CompletionEntry> entries, size_t limit) : limit(limit) {
+  std::vector<std::pair<std::string, const CompletionEntry*>> sorted;
+  sorted.reserve(entries.size());
+  for (const auto& entry : entries) {
+    sorted.push_back({fold(entry.label), &entry});
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+      return std::tie(a.first, a.second->label) < std::tie(b.first, b.second->label);
+      });
+
+  this->entries.reserve(sorted.size());
+  this->folded.reserve(sorted.size());
+  for (auto& [folded, entry] : sorted) {
+    this->folded.push_back(std::move(folded));
+    this->entries.push_back(entry);
+  }
+
+  this->nodes.push_back((TrieNode) { .c = '\0', .first_child = 0, .child_count = 0, .begin = 0, .end = (uint32_t)this->entries.size() });
+  this->build(0, 0);
+}
+
+void CompletionEngine::build(uint32_t node, size_t depth) {
+  uint32_t begin = this->nodes[node].begin;
+  uint32_t end = this->nodes[node].end;
+
+  // labels ending here sort before the longer ones sharing the prefix
+  uint32_t i = begin;
+  while (i < end && this->folded[i].size() == depth) {
+    i++;
+  }
+
+  uint32_t first_child = this->nodes.size();
+  while (i < end) {
+    char c = this->folded[i][depth];
+    uint32_t j = i;
+    while (j < end && this->folded[j][depth] == c) {
+      j++;
+    }
+    this->nodes.push_back((TrieNode) { .c = c, .first_child = 0, .child_count = 0, .begin = i, .end = j });
+    i = j;
+  }
+
+  uint32_t child_count = this->nodes.size() - first_child;
+  this->nodes[node].first_child = first_child;
+  this->nodes[node].child_count = child_count;
+  for (uint32_t child = first_child; child < first_child + child_count; ++child) {
+    this->build(child, depth + 1);
+  }
+}
+
+std::pair<uint32_t, uint32_t> CompletionEngine::prefix_range(std::string_view prefix) const {
+  uint32_t node = 0;
+  for (char c : prefix) {
+    const TrieNode& current = this->nodes[node];
+    auto first = this->nodes.begin() + current.first_child;
+    auto last = first + current.child_count;
+    auto child = std::lower_bound(first, last, c, [](const TrieNode& n, char c) { return n.c < c; });
+    if (child == last || child->c != c) {
+      return {0, 0};
+    }
+    node = child - this->nodes.begin();
+  }
+  return {this->nodes[node].begin, this->nodes[node].end};
+}
+
+std::string_view CompletionEngine::word_before(std::string_view line, size_t column) {
+  size_t end = std::min(column, line.size());
+  size_t start = end;
+  while (start > 0 && is_word_char(line[start - 1])) {
+    start--;
+  }
+  return line.substr(start, end - start);
+}
+
+std::optional<std::string_view> CompletionEngine::require_argument_before(std::string_view line, size_t column) {
+  size_t end = std::min(column, line.size());
+  size_t quote = end == 0 ? std::string_view::npos : line.find_last_of("'\"`", end - 1);
+  if (quote == std::string_view::npos) {
+    return {};
+  }
+
+  // only `require (` and whitespace may come before the quote
+  size_t i = quote;
+  while (i > 0 && std::isspace((unsigned char)line[i - 1])) {
+    i--;
+  }
+  if (i == 0 || line[i - 1] != '(') {
+    return {};
+  }
+  i--;
+  while (i > 0 && std::isspace((unsigned char)line[i - 1])) {
+    i--;
+  }
+  std::string_view callee = line.substr(0, i);
+  if (!callee.ends_with("require") || (callee.size() > 7 && is_word_char(callee[callee.size() - 8]))) {
+    return {};
+  }
+  return line.substr(quote + 1, end - quote - 1);
+}
+
+// subsequence match, rewarding matches at the start of words and runs of consecutive characters
+std::optional<int> CompletionEngine::fuzzy_score(std::string_view pattern, std::string_view label, std::string_view folded) {
+  int score = 0;
+  size_t matched = 0;
+  size_t last = std::string_view::npos;
+  for (size_t i = 0; i < folded.size() && matched < pattern.size(); ++i) {
+    if (folded[i] != pattern[matched]) {
+      continue;
+    }
+
+    int bonus = 1;
+    bool word_start = i == 0 || !std::isalnum((unsigned char)label[i - 1]) ||
+      (std::isupper((unsigned char)label[i]) && std::islower((unsigned char)label[i - 1]));
+    if (word_start) {
+      bonus += 8;
+    }
+    if (last != std::string_view::npos) {
+      if (last + 1 == i) {
+        bonus += 5;
+      } else {
+        score -= std::min((int)(i - last - 1), 5);
+      }
+    }
+
+    score += bonus;
+    last = i;
+    matched++;
+  }
+
+  if (matched < pattern.size()) {
+    return {};
+  }
+  return score;
+}
+
+std::string CompletionEngine::complete(std::string_view word) const {
+  std::string pattern = fold(word);
+  std::vector<std::pair<int, uint32_t>> scored;
+
+  auto [begin, end] = this->prefix_range(pattern);
+  for (uint32_t i = begin; i < end; ++i) {
+    // shorter labels and exact case win among the prefix matches
+    int score = PREFIX_SCORE - (int)(this->folded[i].size() - pattern.size());
+    if (this->entries[i]->label.starts_with(word)) {
+      score += 50;
+    }
+    scored.push_back({score, i});
+  }
+
+  // with enough prefix matches the fuzzy ones would never make it into the result
+  if (scored.size() < this->limit) {
+    for (uint32_t i = 0; i < this->entries.size(); ++i) {
+      if (i >= begin && i < end) {
+        continue;
+      }
+      auto score = fuzzy_score(pattern, this->entries[i]->label, this->folded[i]);
+      if (score.has_value()) {
+        scored.push_back({score.value(), i});
+      }
+    }
+  }
+
+  size_t count = std::min(scored.size(), this->limit);
+  // higher scores first, ties keep the alphabetical order of the table
+  std::partial_sort(scored.begin(), scored.begin() + count, scored.end(), [](const auto& a, const auto& b) {
+      return a.first != b.first ? a.first > b.first : a.second < b.second;
+      });
+
+  // the client asks again as the word grows, whatever was cut off might make it then
+  bool is_incomplete = scored.size() > count;
+  std::string_view head = is_incomplete ? "{\"isIncomplete\":true,\"items\":[" : "{\"isIncomplete\":false,\"items\":[";
+  size_t size = head.size() + 2;
+  for (size_t i = 0; i < count; ++i) {
+    size += this->entries[scored[i].second]->json.size() + 1;
+  }
+
+  std::string result;
+  result.reserve(size);
+  result.append(head);
+  for (size_t i = 0; i < count; ++i) {
+    if (i > 0) {
+      result.push_back(',');
+    }
+    result.append(this->entries[scored[i].second]->json);
+  }
+  result.append("]}");
+  return result;
+}
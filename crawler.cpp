@@ -0,0 +1,174 @@
+#include "crawler.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+using namespace lsp;
+
+static const size_t PROGRESS_INTERVAL = 512;
+
+Crawler::Crawler(size_t thread_count) :
+  thread_count(std::clamp(thread_count, (size_t)1, MAX_CRAWLER_THREADS)),
+  pending(0),
+  pushes(0),
+  visited(0)
+{
+  for (size_t i = 0; i < this->thread_count; ++i) {
+    this->queues.push_back(std::make_unique<WorkerQueue>());
+  }
+}
+
+size_t Crawler::default_thread_count() {
+  const char* configured = std::getenv("SFCC_LSP_CRAWLER_THREADS");
+  if (configured != NULL) {
+    int count = std::atoi(configured);
+    if (count > 0) {
+      return count;
+    }
+  }
+
+  size_t cores = std::thread::hardware_concurrency();
+  return cores == 0 ? 1 : cores;
+}
+
+void Crawler::push(size_t worker, WorkItem item) {
+  this->pending.fetch_add(1);
+  {
+    std::lock_guard<std::mutex> lock(this->queues[worker]->mutex);
+    this->queues[worker]->items.push_back(std::move(item));
+  }
+  this->pushes.fetch_add(1);
+  this->pushes.notify_one();
+}
+
+bool Crawler::pop(size_t worker, WorkItem& item) {
+  {
+    WorkerQueue& own = *this->queues[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.items.empty()) {
+      item = std::move(own.items.back());
+      own.items.pop_back();
+      return true;
+    }
+  }
+
+  for (size_t i = 1; i < this->thread_count; ++i) {
+    WorkerQueue& victim = *this->queues[(worker + i) % this->thread_count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.items.empty()) {
+      item = std::move(victim.items.front());
+      victim.items.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void Crawler::process(size_t worker, const WorkItem& item, WorkerResult& result) {
+  std::string path_str = item.path.string();
+  if (is_forbidden_path(path_str)) return;
+
+  auto mtime = directory_mtime(path_str);
+  if (mtime.has_value()) {
+    result.directories.push_back((DirectoryStamp) { .path = path_str, .mtime = mtime.value() });
+  }
+
+  Listing listing = { .directory = path_str, .key = item.key, .files = {} };
+  std::error_code ec;
+  std::filesystem::directory_iterator it(item.path, ec);
+  // the iterator is advanced by hand, unreadable entries must not throw on a worker thread
+  for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+    const auto& entry = *it;
+    std::string name = entry.path().filename().string();
+
+    std::error_code type_ec;
+    if (entry.is_directory(type_ec)) {
+      if (name == "cartridge") {
+        // the directory holding `cartridge` is the cartridge itself
+        result.cartridges.insert({item.path.filename().string(), path_str});
+        this->push(worker, (WorkItem) { .path = entry.path(), .key = "/cartridge" });
+      } else {
+        this->push(worker, (WorkItem) { .path = entry.path(), .key = item.key.empty() ? "" : item.key + "/" + name });
+      }
+      continue;
+    }
+
+    if (item.key.empty()) {
+      continue;
+    }
+
+    listing.files.push_back(std::move(name));
+  }
+
+  if (!listing.files.empty()) {
+    result.listings.push_back(std::move(listing));
+  }
+}
+
+void Crawler::work(size_t worker, WorkerResult& result) {
+  WorkItem item;
+  while (true) {
+    // read before looking for work, a push after this changes it and the wait below returns right away
+    uint32_t pushes = this->pushes.load();
+    if (this->pop(worker, item)) {
+      this->process(worker, item, result);
+      if (this->pending.fetch_sub(1) == 1) {
+        // that was the last directory, everyone waiting can leave
+        this->pushes.fetch_add(1);
+        this->pushes.notify_all();
+      }
+
+      size_t visited = this->visited.fetch_add(1) + 1;
+      if (this->on_progress && visited % PROGRESS_INTERVAL == 0) {
+        this->on_progress(visited);
+      }
+      continue;
+    }
+
+    if (this->pending.load() == 0) {
+      return;
+    }
+    this->pushes.wait(pushes);
+  }
+}
+
+FileIndex Crawler::crawl(const std::string& root, std::function<void(size_t)> on_progress) {
+  this->on_progress = on_progress;
+  this->visited = 0;
+  std::vector<WorkerResult> results(this->thread_count);
+  this->push(0, (WorkItem) { .path = std::filesystem::path(root), .key = "" });
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < this->thread_count; ++i) {
+    threads.emplace_back(&Crawler::work, this, i, std::ref(results[i]));
+  }
+  this->work(0, results[0]);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  FileIndex merged;
+  std::vector<Listing> listings;
+  for (auto& result : results) {
+    merged.cartridges.merge(result.cartridges);
+    merged.directories.insert(merged.directories.end(),
+        std::make_move_iterator(result.directories.begin()),
+        std::make_move_iterator(result.directories.end()));
+    listings.insert(listings.end(), std::make_move_iterator(result.listings.begin()), std::make_move_iterator(result.listings.end()));
+  }
+
+  // the order the workers visited things in is random, intern in path order so ids are stable between runs
+  std::sort(listings.begin(), listings.end(), [](const Listing& a, const Listing& b) { return a.directory < b.directory; });
+  std::string key;
+  for (auto& listing : listings) {
+    std::sort(listing.files.begin(), listing.files.end());
+    uint32_t directory = merged.fc.add_directory(listing.directory);
+    for (const auto& name : listing.files) {
+      key.assign(listing.key).append("/").append(name);
+      merged.fc.add_file(directory, name, key);
+    }
+  }
+
+  return merged;
+}
@@ -0,0 +1,101 @@
+#include "dispatcher.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace lsp;
+
+static const size_t MAX_REQUEST_THREADS = 16;
+
+Dispatcher::Dispatcher(size_t thread_count) :
+  thread_count(std::clamp(thread_count, (size_t)1, MAX_REQUEST_THREADS))
+{
+  for (size_t i = 0; i < this->thread_count; ++i) {
+    this->threads.emplace_back(&Dispatcher::work, this);
+  }
+}
+
+Dispatcher::~Dispatcher() {
+  this->stop();
+}
+
+size_t Dispatcher::default_thread_count() {
+  const char* configured = std::getenv("SFCC_LSP_REQUEST_THREADS");
+  if (configured != NULL) {
+    int count = std::atoi(configured);
+    if (count > 0) {
+      return count;
+    }
+  }
+
+  size_t cores = std::thread::hardware_concurrency();
+  return cores == 0 ? 1 : cores;
+}
+
+void Dispatcher::submit(std::string id, std::string supersede_key, std::function<void(const CancelToken&)> run) {
+  CancelToken token = std::make_shared<std::atomic<bool>>(false);
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->stopping) {
+      return;
+    }
+
+    if (!supersede_key.empty()) {
+      auto previous = this->latest.find(supersede_key);
+      if (previous != this->latest.end()) {
+        auto stale = this->in_flight.find(previous->second);
+        if (stale != this->in_flight.end()) {
+          stale->second->store(true);
+        }
+      }
+      this->latest[supersede_key] = id;
+    }
+
+    this->in_flight[id] = token;
+    this->jobs.push_back((Job) { .id = std::move(id), .cancelled = token, .run = std::move(run) });
+  }
+  this->cv.notify_one();
+}
+
+void Dispatcher::cancel(const std::string& id) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto it = this->in_flight.find(id);
+  if (it != this->in_flight.end()) {
+    it->second->store(true);
+  }
+}
+
+void Dispatcher::stop() {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopping = true;
+    this->jobs.clear();
+  }
+  this->cv.notify_all();
+
+  for (auto& thread : this->threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+void Dispatcher::work() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->cv.wait(lock, [this]() { return this->stopping || !this->jobs.empty(); });
+      if (this->stopping) {
+        return;
+      }
+      job = std::move(this->jobs.front());
+      this->jobs.pop_front();
+    }
+
+    job.run(job.cancelled);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->in_flight.erase(job.id);
+    std::erase_if(this->latest, [&job](const auto& entry) { return entry.second == job.id; });
+  }
+}
@@ -0,0 +1,300 @@
+#include "includes/lsp.hpp"
+#include "document.hpp"
+#include <algorithm>
+
+using namespace lsp;
+
+// merging the pieces back into a single buffer keeps the piece lookups short on long editing sessions
+static const size_t MAX_PIECES = 1024;
+
+size_t lsp::utf16_length(std::string_view text) {
+  size_t units = 0;
+  for (unsigned char c : text) {
+    // continuation bytes add nothing, four byte sequences need a surrogate pair
+    if ((c & 0xC0) != 0x80) {
+      units += c >= 0xF0 ? 2 : 1;
+    }
+  }
+  return units;
+}
+
+size_t lsp::utf16_offset(std::string_view text, size_t units) {
+  size_t counted = 0;
+  for (size_t i = 0; i < text.size(); ++i) {
+    unsigned char c = text[i];
+    if ((c & 0xC0) == 0x80) {
+      continue;
+    }
+
+    counted += c >= 0xF0 ? 2 : 1;
+    if (counted > units) {
+      return i;
+    }
+  }
+  return text.size();
+}
+
+Document::Document(std::string text, int version) : version(version) {
+  this->replace(std::move(text));
+}
+
+Document::Document(const Document& other) :
+  pieces(other.pieces),
+  line_starts(other.line_starts),
+  length(other.length),
+  version(other.version),
+  tree(other.tree != nullptr ? ts_tree_copy(other.tree) : nullptr),
+  symbols(other.symbols)
+{}
+
+Document::Document(Document&& other) noexcept :
+  pieces(std::move(other.pieces)),
+  line_starts(std::move(other.line_starts)),
+  length(other.length),
+  version(other.version),
+  tree(other.tree),
+  symbols(std::move(other.symbols))
+{
+  other.tree = nullptr;
+}
+
+Document& Document::operator=(Document other) noexcept {
+  std::swap(this->pieces, other.pieces);
+  std::swap(this->line_starts, other.line_starts);
+  std::swap(this->length, other.length);
+  std::swap(this->version, other.version);
+  std::swap(this->tree, other.tree);
+  std::swap(this->symbols, other.symbols);
+  return *this;
+}
+
+Document::~Document() {
+  if (this->tree != nullptr) {
+    ts_tree_delete(this->tree);
+  }
+}
+
+void Document::set_tree(TSTree* tree) {
+  if (this->tree != nullptr && this->tree != tree) {
+    ts_tree_delete(this->tree);
+  }
+  this->tree = tree;
+}
+
+void Document::replace(std::string text) {
+  // nothing of the old tree can be reused
+  this->set_tree(nullptr);
+  this->symbols = nullptr;
+  this->pieces.clear();
+  this->line_starts = { 0 };
+  this->length = text.size();
+
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '\n') {
+      this->line_starts.push_back(i + 1);
+    }
+  }
+
+  if (!text.empty()) {
+    this->pieces.push_back((Piece) {
+        .buffer = std::make_shared<const std::string>(std::move(text)),
+        .offset = 0,
+        .length = this->length,
+        });
+  }
+}
+
+// makes sure a piece starts exactly at `offset` and returns its index
+size_t Document::split_at(size_t offset) {
+  size_t piece_start = 0;
+  for (size_t i = 0; i < this->pieces.size(); ++i) {
+    Piece& piece = this->pieces[i];
+    if (offset == piece_start) {
+      return i;
+    }
+
+    if (offset < piece_start + piece.length) {
+      size_t left = offset - piece_start;
+      Piece right = {
+        .buffer = piece.buffer,
+        .offset = piece.offset + left,
+        .length = piece.length - left,
+      };
+      piece.length = left;
+      this->pieces.insert(this->pieces.begin() + i + 1, right);
+      return i + 1;
+    }
+
+    piece_start += piece.length;
+  }
+
+  return this->pieces.size();
+}
+
+void Document::compact() {
+  TSTree* tree = this->tree;
+  this->tree = nullptr;
+  this->replace(this->text());
+  // the contents did not change, only their layout
+  this->tree = tree;
+}
+
+void Document::apply_change(const Range& range, std::string text) {
+  size_t start = this->offset_at(range.start);
+  size_t end = this->offset_at(range.end);
+  if (end < start) {
+    std::swap(start, end);
+  }
+
+  TSPoint start_point = this->point_at(start);
+  TSPoint old_end_point = this->point_at(end);
+  this->symbols = nullptr;
+
+  size_t first = this->split_at(start);
+  size_t last = this->split_at(end);
+  this->pieces.erase(this->pieces.begin() + first, this->pieces.begin() + last);
+
+  // line starts inside of the removed range are gone, the ones after it are shifted
+  // by the size difference and the inserted text brings its own
+  std::vector<size_t> inserted_starts;
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '\n') {
+      inserted_starts.push_back(start + i + 1);
+    }
+  }
+
+  auto lo = std::upper_bound(this->line_starts.begin(), this->line_starts.end(), start);
+  auto hi = std::upper_bound(lo, this->line_starts.end(), end);
+  lo = this->line_starts.erase(lo, hi);
+
+  for (auto it = lo; it != this->line_starts.end(); ++it) {
+    *it = *it - (end - start) + text.size();
+  }
+  this->line_starts.insert(lo, inserted_starts.begin(), inserted_starts.end());
+
+  size_t text_size = text.size();
+  this->length = this->length - (end - start) + text_size;
+
+  if (!text.empty()) {
+    this->pieces.insert(this->pieces.begin() + first, (Piece) {
+        .buffer = std::make_shared<const std::string>(std::move(text)),
+        .offset = 0,
+        .length = text_size,
+        });
+  }
+
+  if (this->tree != nullptr) {
+    TSInputEdit edit = {
+      .start_byte = (uint32_t)start,
+      .old_end_byte = (uint32_t)end,
+      .new_end_byte = (uint32_t)(start + text_size),
+      .start_point = start_point,
+      .old_end_point = old_end_point,
+      .new_end_point = this->point_at(start + text_size),
+    };
+    ts_tree_edit(this->tree, &edit);
+  }
+
+  if (this->pieces.size() > MAX_PIECES) {
+    this->compact();
+  }
+}
+
+size_t Document::offset_at(const Position& position) const {
+  if (position.line < 0) {
+    return 0;
+  }
+
+  size_t line = position.line;
+  if (line >= this->line_starts.size()) {
+    return this->length;
+  }
+
+  std::string scratch;
+  std::string_view text = this->line_view(line, scratch);
+  size_t character = position.character < 0 ? 0 : position.character;
+  return this->line_starts[line] + utf16_offset(text, character);
+}
+
+Position Document::position_at(size_t offset) const {
+  TSPoint point = this->point_at(offset);
+  std::string scratch;
+  std::string_view text = this->line_view(point.row, scratch);
+
+  return (Position) {
+    .line = (int)point.row,
+    .character = (int)utf16_length(text.substr(0, point.column)),
+  };
+}
+
+TSPoint Document::point_at(size_t offset) const {
+  offset = std::min(offset, this->length);
+  auto it = std::upper_bound(this->line_starts.begin(), this->line_starts.end(), offset);
+  size_t line = (it - this->line_starts.begin()) - 1;
+
+  return (TSPoint) {
+    .row = (uint32_t)line,
+    .column = (uint32_t)(offset - this->line_starts[line]),
+  };
+}
+
+std::string Document::text(size_t start, size_t end) const {
+  std::string result;
+  end = std::min(end, this->length);
+  if (start >= end) {
+    return result;
+  }
+  result.reserve(end - start);
+
+  size_t piece_start = 0;
+  for (const auto& piece : this->pieces) {
+    size_t piece_end = piece_start + piece.length;
+    if (piece_end > start && piece_start < end) {
+      size_t from = std::max(start, piece_start);
+      size_t to = std::min(end, piece_end);
+      result.append(*piece.buffer, piece.offset + (from - piece_start), to - from);
+    }
+
+    if (piece_end >= end) {
+      break;
+    }
+    piece_start = piece_end;
+  }
+
+  return result;
+}
+
+std::string Document::text() const {
+  return this->text(0, this->length);
+}
+
+std::string_view Document::line_view(size_t line, std::string& scratch) const {
+  if (line >= this->line_starts.size()) {
+    return "";
+  }
+
+  size_t start = this->line_starts[line];
+  size_t end = line + 1 < this->line_starts.size() ? this->line_starts[line + 1] - 1 : this->length;
+  size_t piece_start = 0;
+  for (const auto& piece : this->pieces) {
+    size_t piece_end = piece_start + piece.length;
+    if (start < piece_end) {
+      if (end <= piece_end) {
+        return std::string_view(*piece.buffer).substr(piece.offset + (start - piece_start), end - start);
+      }
+      break;
+    }
+    piece_start = piece_end;
+  }
+
+  if (start >= end) {
+    return "";
+  }
+  scratch = this->text(start, end);
+  return scratch;
+}
+
+std::string Document::line(size_t line) const {
+  std::string scratch;
+  return std::string(this->line_view(line, scratch));
+}
@@ -0,0 +1,69 @@
+#include "export_index.hpp"
+#include <mutex>
+
+using namespace lsp;
+
+void ExportIndex::set(const std::string& path, ModuleExports exports, bool replace) {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  if (replace) {
+    this->modules.insert_or_assign(path, std::move(exports));
+  } else {
+    this->modules.try_emplace(path, std::move(exports));
+  }
+}
+
+void ExportIndex::remove(const std::string& path) {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  this->modules.erase(path);
+}
+
+void ExportIndex::remove_under(const std::vector<std::string>& directories) {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  std::erase_if(this->modules, [&directories](const auto& module) {
+      const std::string& path = module.first;
+      for (const auto& directory : directories) {
+        if (path.size() > directory.size() && path.starts_with(directory) && path[directory.size()] == '/') {
+          return true;
+        }
+      }
+      return false;
+      });
+}
+
+void ExportIndex::clear() {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  this->modules.clear();
+}
+
+std::optional<Export> ExportIndex::find(const std::string& path, std::string_view name) const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  auto module = this->modules.find(path);
+  if (module == this->modules.end()) {
+    return {};
+  }
+
+  auto it = module->second.find(std::string(name));
+  if (it == module->second.end()) {
+    return {};
+  }
+  return it->second;
+}
+
+std::optional<ModuleExports> ExportIndex::get(const std::string& path) const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  auto module = this->modules.find(path);
+  if (module == this->modules.end()) {
+    return {};
+  }
+  return module->second;
+}
+
+bool ExportIndex::contains(const std::string& path) const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  return this->modules.contains(path);
+}
+
+size_t ExportIndex::size() const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  return this->modules.size();
+}
@@ -0,0 +1,744 @@
+#include "file_cache.hpp"
+#include "hash.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace lsp;
+
+static const char FILE_INDEX_MAGIC[8] = { 'S', 'F', 'C', 'C', 'I', 'D', 'X', '\0' };
+
+// the stamp and cartridge records are fixed size and 8 byte aligned, so they are read in place.
+// their strings are stored relative to the workspace root in one blob at the end of the file.
+// the arrays and hash tables of the cache follow them as they are in memory and are copied out.
+struct StringRef {
+  uint32_t offset;
+  uint32_t length;
+};
+
+struct IndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t directory_count;
+  uint32_t cartridge_count;
+  uint32_t component_count;
+  uint32_t cache_directory_count;
+  uint32_t file_count;
+  uint32_t key_count;
+  uint32_t component_table_size;
+  uint32_t directory_table_size;
+  uint32_t key_table_size;
+  uint32_t free_file_count;
+  uint32_t live_keys;
+  uint32_t live_files;
+  uint32_t reserved;
+  uint64_t arena_size;
+  uint64_t strings_size;
+  StringRef root;
+};
+
+struct DirectoryRecord {
+  StringRef path;
+  int64_t mtime;
+};
+
+struct CartridgeRecord {
+  StringRef name;
+  StringRef path;
+};
+
+static std::string relative_to_root(const std::string& path, const std::string& root) {
+  if (path.compare(0, root.size(), root) == 0) {
+    return path.substr(root.size());
+  }
+  return path;
+}
+
+std::optional<int64_t> lsp::directory_mtime(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return {};
+  }
+  return (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+bool lsp::is_forbidden_path(const std::string& path) {
+    return path.find(".git") != std::string::npos ||
+      path.find("node_modules") != std::string::npos ||
+      path.find("test") != std::string::npos;
+}
+
+std::optional<std::string> lsp::cartridge_key(const std::string& path) {
+  size_t pos = path.rfind("/cartridge/");
+  if (pos == std::string::npos) {
+    return {};
+  }
+  return path.substr(pos);
+}
+
+CartridgeRanks lsp::cartridge_ranks(const std::vector<std::string>& cartridge_path) {
+  CartridgeRanks ranks;
+  for (size_t i = 0; i < cartridge_path.size(); ++i) {
+    // a cartridge listed twice is resolved at its first position
+    ranks.insert({cartridge_path[i], i});
+  }
+  return ranks;
+}
+
+std::string lsp::cartridge_name(const std::string& path) {
+  size_t pos = path.rfind("/cartridge/");
+  if (pos == std::string::npos) {
+    return "";
+  }
+
+  size_t start = path.rfind('/', pos - 1);
+  start = start == std::string::npos ? 0 : start + 1;
+  return path.substr(start, pos - start);
+}
+
+static uint64_t pair_hash(uint32_t a, uint32_t b) {
+  uint64_t pair = (uint64_t)a << 32 | b;
+  return fnv1a(std::string_view((const char*)&pair, sizeof(pair)));
+}
+
+static bool is_power_of_two(size_t n) {
+  return n > 0 && (n & (n - 1)) == 0;
+}
+
+// slot holding the id `equals` accepts, or the empty slot it would go in
+template <typename Equals>
+static size_t find_slot(const std::vector<uint32_t>& table, uint64_t hash, Equals equals) {
+  size_t mask = table.size() - 1;
+  size_t slot = hash & mask;
+  while (table[slot] != 0 && !equals(table[slot] - 1)) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+// keeps the load below 70%, growing places every id again
+template <typename Hash>
+static void reserve_slot(std::vector<uint32_t>& table, size_t count, Hash hash) {
+  if (!table.empty() && (count + 1) * 10 <= table.size() * 7) {
+    return;
+  }
+
+  std::vector<uint32_t> grown(std::max(table.size() * 2, (size_t)64), 0);
+  size_t mask = grown.size() - 1;
+  for (uint32_t value : table) {
+    if (value == 0) {
+      continue;
+    }
+    size_t slot = hash(value - 1) & mask;
+    while (grown[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    grown[slot] = value;
+  }
+  table.swap(grown);
+}
+
+FileCache::Span FileCache::add_string(std::string_view str) {
+  Span span = { .offset = (uint32_t)this->strings.size(), .length = (uint32_t)str.size() };
+  this->strings.append(str);
+  return span;
+}
+
+uint32_t FileCache::find_component(std::string_view name) const {
+  if (this->component_table.empty()) {
+    return NO_ID;
+  }
+  size_t slot = find_slot(this->component_table, fnv1a(name), [this, name](uint32_t id) {
+      return this->view(this->components[id]) == name;
+      });
+  return this->component_table[slot] - 1;
+}
+
+uint32_t FileCache::intern_component(std::string_view name) {
+  uint32_t id = this->find_component(name);
+  if (id != NO_ID) {
+    return id;
+  }
+
+  reserve_slot(this->component_table, this->components.size(), [this](uint32_t id) {
+      return fnv1a(this->view(this->components[id]));
+      });
+  id = this->components.size();
+  this->components.push_back(this->add_string(name));
+  size_t slot = find_slot(this->component_table, fnv1a(name), [](uint32_t) { return false; });
+  this->component_table[slot] = id + 1;
+  return id;
+}
+
+uint32_t FileCache::find_directory(uint32_t parent, uint32_t name) const {
+  if (this->directory_table.empty()) {
+    return NO_ID;
+  }
+  size_t slot = find_slot(this->directory_table, pair_hash(parent, name), [this, parent, name](uint32_t id) {
+      return this->directories[id].parent == parent && this->directories[id].name == name;
+      });
+  return this->directory_table[slot] - 1;
+}
+
+uint32_t FileCache::intern_directory(uint32_t parent, uint32_t name) {
+  uint32_t id = this->find_directory(parent, name);
+  if (id != NO_ID) {
+    return id;
+  }
+
+  reserve_slot(this->directory_table, this->directories.size(), [this](uint32_t id) {
+      return pair_hash(this->directories[id].parent, this->directories[id].name);
+      });
+  id = this->directories.size();
+  this->directories.push_back((Directory) { .parent = parent, .name = name });
+  size_t slot = find_slot(this->directory_table, pair_hash(parent, name), [](uint32_t) { return false; });
+  this->directory_table[slot] = id + 1;
+  return id;
+}
+
+uint32_t FileCache::find_key(std::string_view key) const {
+  if (this->key_table.empty()) {
+    return NO_ID;
+  }
+  size_t slot = find_slot(this->key_table, fnv1a(key), [this, key](uint32_t id) {
+      return this->view(this->keys[id].name) == key;
+      });
+  return this->key_table[slot] - 1;
+}
+
+uint32_t FileCache::intern_key(std::string_view key) {
+  uint32_t id = this->find_key(key);
+  if (id != NO_ID) {
+    return id;
+  }
+
+  reserve_slot(this->key_table, this->keys.size(), [this](uint32_t id) {
+      return fnv1a(this->view(this->keys[id].name));
+      });
+  id = this->keys.size();
+  this->keys.push_back((Key) { .name = this->add_string(key), .head = NO_ID, .count = 0 });
+  size_t slot = find_slot(this->key_table, fnv1a(key), [](uint32_t) { return false; });
+  this->key_table[slot] = id + 1;
+  return id;
+}
+
+uint32_t FileCache::add_directory(std::string_view path) {
+  uint32_t directory = NO_ID;
+  size_t start = 0;
+  while (start < path.size()) {
+    size_t end = std::min(path.find('/', start), path.size());
+    if (end > start) {
+      directory = this->intern_directory(directory, this->intern_component(path.substr(start, end - start)));
+    }
+    start = end + 1;
+  }
+  return directory;
+}
+
+uint32_t FileCache::lookup_directory(std::string_view path) const {
+  uint32_t directory = NO_ID;
+  size_t start = 0;
+  while (start < path.size()) {
+    size_t end = std::min(path.find('/', start), path.size());
+    if (end > start) {
+      uint32_t name = this->find_component(path.substr(start, end - start));
+      directory = name == NO_ID ? NO_ID : this->find_directory(directory, name);
+      if (directory == NO_ID) {
+        return NO_ID;
+      }
+    }
+    start = end + 1;
+  }
+  return directory;
+}
+
+std::string FileCache::directory_path(uint32_t directory) const {
+  std::vector<uint32_t> names;
+  for (; directory != NO_ID; directory = this->directories[directory].parent) {
+    names.push_back(this->directories[directory].name);
+  }
+
+  std::string path;
+  for (auto it = names.rbegin(); it != names.rend(); ++it) {
+    path.push_back('/');
+    path.append(this->view(this->components[*it]));
+  }
+  return path;
+}
+
+std::string FileCache::path(uint32_t file) const {
+  std::string path = this->directory_path(this->files[file].directory);
+  path.push_back('/');
+  path.append(this->view(this->components[this->files[file].name]));
+  return path;
+}
+
+std::vector<std::string> FileCache::paths() const {
+  std::vector<std::string> paths;
+  paths.reserve(this->live_files);
+  for (uint32_t file = 0; file < this->files.size(); ++file) {
+    if (this->files[file].directory != NO_ID) {
+      paths.push_back(this->path(file));
+    }
+  }
+  return paths;
+}
+
+size_t FileCache::file_rank(uint32_t file) const {
+  auto rank = this->ranks.find(this->view(this->components[this->files[file].cartridge]));
+  return rank == this->ranks.end() ? SIZE_MAX : rank->second;
+}
+
+bool FileCache::chain_less(uint32_t a, uint32_t b) const {
+  size_t rank_a = this->file_rank(a);
+  size_t rank_b = this->file_rank(b);
+  if (rank_a != rank_b) {
+    return rank_a < rank_b;
+  }
+
+  // building whole paths is only needed for two cartridges of the same name
+  uint32_t cartridge_a = this->files[a].cartridge;
+  uint32_t cartridge_b = this->files[b].cartridge;
+  if (cartridge_a != cartridge_b) {
+    return this->view(this->components[cartridge_a]) < this->view(this->components[cartridge_b]);
+  }
+  return this->path(a) < this->path(b);
+}
+
+void FileCache::link(uint32_t file) {
+  Key& key = this->keys[this->files[file].key];
+  if (key.count++ == 0) {
+    this->live_keys++;
+    this->module_trie.insert(this->view(key.name));
+  }
+
+  if (key.head == NO_ID || this->chain_less(file, key.head)) {
+    this->files[file].next = key.head;
+    key.head = file;
+    return;
+  }
+
+  uint32_t prev = key.head;
+  while (this->files[prev].next != NO_ID && !this->chain_less(file, this->files[prev].next)) {
+    prev = this->files[prev].next;
+  }
+  this->files[file].next = this->files[prev].next;
+  this->files[prev].next = file;
+}
+
+void FileCache::unlink(uint32_t file) {
+  Key& key = this->keys[this->files[file].key];
+  if (key.head == file) {
+    key.head = this->files[file].next;
+  } else {
+    uint32_t prev = key.head;
+    while (this->files[prev].next != file) {
+      prev = this->files[prev].next;
+    }
+    this->files[prev].next = this->files[file].next;
+  }
+
+  if (--key.count == 0) {
+    this->live_keys--;
+    this->module_trie.remove(this->view(key.name));
+  }
+  this->files[file].directory = NO_ID;
+  this->files[file].next = NO_ID;
+  this->free_files.push_back(file);
+  this->live_files--;
+}
+
+bool FileCache::add_file(uint32_t directory, std::string_view name, std::string_view key) {
+  if (directory == NO_ID || !key.starts_with("/cartridge/")) {
+    return false;
+  }
+
+  // `/cartridge/a/b.js` lives two directories below the cartridge
+  uint32_t cartridge = directory;
+  for (size_t depth = std::count(key.begin(), key.end(), '/') - 1; depth > 0 && cartridge != NO_ID; --depth) {
+    cartridge = this->directories[cartridge].parent;
+  }
+  if (cartridge == NO_ID) {
+    return false;
+  }
+
+  uint32_t name_id = this->intern_component(name);
+  uint32_t key_id = this->intern_key(key);
+  for (uint32_t it = this->keys[key_id].head; it != NO_ID; it = this->files[it].next) {
+    if (this->files[it].directory == directory && this->files[it].name == name_id) {
+      return false;
+    }
+  }
+
+  File entry = {
+    .directory = directory,
+    .name = name_id,
+    .key = key_id,
+    .cartridge = this->directories[cartridge].name,
+    .next = NO_ID,
+  };
+
+  uint32_t id;
+  if (!this->free_files.empty()) {
+    id = this->free_files.back();
+    this->free_files.pop_back();
+    this->files[id] = entry;
+  } else {
+    id = this->files.size();
+    this->files.push_back(entry);
+  }
+
+  this->live_files++;
+  this->link(id);
+  return true;
+}
+
+bool FileCache::add(const std::string& path) {
+  auto key = cartridge_key(path);
+  size_t slash = path.rfind('/');
+  if (!key.has_value() || slash == std::string::npos) {
+    return false;
+  }
+
+  std::string_view view(path);
+  return this->add_file(this->add_directory(view.substr(0, slash)), view.substr(slash + 1), key.value());
+}
+
+bool FileCache::remove(const std::string& path) {
+  auto key = cartridge_key(path);
+  size_t slash = path.rfind('/');
+  if (!key.has_value() || slash == std::string::npos) {
+    return false;
+  }
+
+  std::string_view view(path);
+  uint32_t directory = this->lookup_directory(view.substr(0, slash));
+  uint32_t name = this->find_component(view.substr(slash + 1));
+  uint32_t key_id = this->find_key(key.value());
+  if (directory == NO_ID || name == NO_ID || key_id == NO_ID) {
+    return false;
+  }
+
+  for (uint32_t it = this->keys[key_id].head; it != NO_ID; it = this->files[it].next) {
+    if (this->files[it].directory == directory && this->files[it].name == name) {
+      this->unlink(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t FileCache::remove_under(const std::vector<std::string>& removed) {
+  // 0 unknown, 1 below a removed directory, 2 not. settled once per directory, not per file
+  std::vector<uint8_t> state(this->directories.size(), 0);
+  for (const auto& path : removed) {
+    uint32_t directory = this->lookup_directory(path);
+    if (directory != NO_ID) {
+      state[directory] = 1;
+    }
+  }
+
+  std::vector<uint32_t> walked;
+  auto is_removed = [this, &state, &walked](uint32_t directory) {
+    walked.clear();
+    uint32_t it = directory;
+    while (it != NO_ID && state[it] == 0) {
+      walked.push_back(it);
+      it = this->directories[it].parent;
+    }
+    uint8_t result = it == NO_ID ? 2 : state[it];
+    for (uint32_t id : walked) {
+      state[id] = result;
+    }
+    return result == 1;
+  };
+
+  size_t count = 0;
+  for (uint32_t file = 0; file < this->files.size(); ++file) {
+    if (this->files[file].directory != NO_ID && is_removed(this->files[file].directory)) {
+      this->unlink(file);
+      count++;
+    }
+  }
+  return count;
+}
+
+void FileCache::set_ranks(const CartridgeRanks& ranks) {
+  this->ranks = ranks;
+
+  std::vector<uint32_t> chain;
+  for (auto& key : this->keys) {
+    if (key.count < 2) {
+      continue;
+    }
+
+    chain.clear();
+    for (uint32_t it = key.head; it != NO_ID; it = this->files[it].next) {
+      chain.push_back(it);
+    }
+    std::sort(chain.begin(), chain.end(), [this](uint32_t a, uint32_t b) { return this->chain_less(a, b); });
+
+    key.head = NO_ID;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+      this->files[*it].next = key.head;
+      key.head = *it;
+    }
+  }
+}
+
+std::vector<std::string> FileCache::lookup(std::string_view key) const {
+  std::vector<std::string> paths;
+  uint32_t id = this->find_key(key);
+  if (id == NO_ID) {
+    return paths;
+  }
+
+  paths.reserve(this->keys[id].count);
+  for (uint32_t it = this->keys[id].head; it != NO_ID; it = this->files[it].next) {
+    paths.push_back(this->path(it));
+  }
+  return paths;
+}
+
+std::filesystem::path lsp::file_index_path(const std::filesystem::path& data_dir, const std::string& root) {
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.index", (unsigned long long)fnv1a(root));
+  return data_dir / name;
+}
+
+template <typename T>
+static void write_array(std::ofstream& out, const std::vector<T>& items) {
+  out.write((const char*)items.data(), items.size() * sizeof(T));
+}
+
+bool lsp::save_file_index(const std::filesystem::path& index_path, const std::string& root, const FileIndex& index) {
+  const FileCache& fc = index.fc;
+  const std::vector<DirectoryStamp>& directories = index.directories;
+
+  std::string strings;
+  auto add_string = [&strings](const std::string& str) {
+    StringRef ref = { .offset = (uint32_t)strings.size(), .length = (uint32_t)str.size() };
+    strings.append(str);
+    return ref;
+  };
+
+  IndexHeader header;
+  memcpy(header.magic, FILE_INDEX_MAGIC, sizeof(FILE_INDEX_MAGIC));
+  header.version = FILE_INDEX_VERSION;
+  header.directory_count = directories.size();
+  header.cartridge_count = index.cartridges.size();
+  header.component_count = fc.components.size();
+  header.cache_directory_count = fc.directories.size();
+  header.file_count = fc.files.size();
+  header.key_count = fc.keys.size();
+  header.component_table_size = fc.component_table.size();
+  header.directory_table_size = fc.directory_table.size();
+  header.key_table_size = fc.key_table.size();
+  header.free_file_count = fc.free_files.size();
+  header.live_keys = fc.live_keys;
+  header.live_files = fc.live_files;
+  header.reserved = 0;
+  header.arena_size = fc.strings.size();
+  header.root = add_string(root);
+
+  std::vector<DirectoryRecord> directory_records;
+  directory_records.reserve(directories.size());
+  for (const auto& directory : directories) {
+    directory_records.push_back((DirectoryRecord) {
+        .path = add_string(relative_to_root(directory.path, root)),
+        .mtime = directory.mtime,
+        });
+  }
+
+  std::vector<CartridgeRecord> cartridge_records;
+  cartridge_records.reserve(index.cartridges.size());
+  for (const auto& [name, path] : index.cartridges) {
+    cartridge_records.push_back((CartridgeRecord) {
+        .name = add_string(name),
+        .path = add_string(relative_to_root(path, root)),
+        });
+  }
+  header.strings_size = strings.size();
+
+  // written next to the real index and renamed over it, so a crash never leaves half an index behind
+  std::filesystem::path tmp_path = index_path;
+  tmp_path += ".tmp";
+  std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    return false;
+  }
+
+  out.write((const char*)&header, sizeof(header));
+  write_array(out, directory_records);
+  write_array(out, cartridge_records);
+  write_array(out, fc.components);
+  write_array(out, fc.directories);
+  write_array(out, fc.files);
+  write_array(out, fc.keys);
+  write_array(out, fc.component_table);
+  write_array(out, fc.directory_table);
+  write_array(out, fc.key_table);
+  write_array(out, fc.free_files);
+  out.write(fc.strings.data(), fc.strings.size());
+  out.write(strings.data(), strings.size());
+  out.close();
+  if (out.fail()) {
+    return false;
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, index_path, ec);
+  return !ec;
+}
+
+std::optional<FileIndex> lsp::load_file_index(const std::filesystem::path& index_path, const std::string& root) {
+  int fd = open(index_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return {};
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(IndexHeader)) {
+    close(fd);
+    return {};
+  }
+
+  size_t size = st.st_size;
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return {};
+  }
+
+  const char* data = (const char*)mapping;
+  auto invalid = [mapping, size]() -> std::optional<FileIndex> {
+    munmap(mapping, size);
+    return {};
+  };
+
+  const IndexHeader* header = (const IndexHeader*)data;
+  if (memcmp(header->magic, FILE_INDEX_MAGIC, sizeof(FILE_INDEX_MAGIC)) != 0 || header->version != FILE_INDEX_VERSION) {
+    return invalid();
+  }
+
+  size_t directories_offset = sizeof(IndexHeader);
+  size_t cartridges_offset = directories_offset + (size_t)header->directory_count * sizeof(DirectoryRecord);
+  size_t cache_offset = cartridges_offset + (size_t)header->cartridge_count * sizeof(CartridgeRecord);
+  size_t cache_size =
+    (size_t)header->component_count * sizeof(FileCache::Span) +
+    (size_t)header->cache_directory_count * sizeof(FileCache::Directory) +
+    (size_t)header->file_count * sizeof(FileCache::File) +
+    (size_t)header->key_count * sizeof(FileCache::Key) +
+    ((size_t)header->component_table_size + header->directory_table_size + header->key_table_size + header->free_file_count) * sizeof(uint32_t) +
+    header->arena_size;
+  size_t strings_offset = cache_offset + cache_size;
+  if (strings_offset + header->strings_size != size) {
+    return invalid();
+  }
+
+  const char* strings = data + strings_offset;
+  auto in_bounds = [header](StringRef ref) {
+    return (uint64_t)ref.offset + ref.length <= header->strings_size;
+  };
+  auto view = [strings](StringRef ref) {
+    return std::string_view(strings + ref.offset, ref.length);
+  };
+
+  if (!in_bounds(header->root) || view(header->root) != root) {
+    return invalid();
+  }
+
+  const DirectoryRecord* directory_records = (const DirectoryRecord*)(data + directories_offset);
+  std::vector<DirectoryStamp> stamps;
+  stamps.reserve(header->directory_count);
+  for (size_t i = 0; i < header->directory_count; ++i) {
+    if (!in_bounds(directory_records[i].path)) {
+      return invalid();
+    }
+
+    std::string path = root;
+    path.append(view(directory_records[i].path));
+    auto mtime = directory_mtime(path);
+    if (!mtime.has_value() || mtime.value() != directory_records[i].mtime) {
+      return invalid();
+    }
+    stamps.push_back((DirectoryStamp) { .path = std::move(path), .mtime = directory_records[i].mtime });
+  }
+
+  FileIndex index;
+  index.directories = std::move(stamps);
+
+  const CartridgeRecord* cartridge_records = (const CartridgeRecord*)(data + cartridges_offset);
+  for (size_t i = 0; i < header->cartridge_count; ++i) {
+    if (!in_bounds(cartridge_records[i].name) || !in_bounds(cartridge_records[i].path)) {
+      return invalid();
+    }
+
+    std::string path = root;
+    path.append(view(cartridge_records[i].path));
+    index.cartridges.insert({std::string(view(cartridge_records[i].name)), std::move(path)});
+  }
+
+  FileCache& fc = index.fc;
+  const char* cursor = data + cache_offset;
+  auto read_array = [&cursor](auto& items, size_t count) {
+    items.resize(count);
+    memcpy((void*)items.data(), cursor, count * sizeof(items[0]));
+    cursor += count * sizeof(items[0]);
+  };
+  read_array(fc.components, header->component_count);
+  read_array(fc.directories, header->cache_directory_count);
+  read_array(fc.files, header->file_count);
+  read_array(fc.keys, header->key_count);
+  read_array(fc.component_table, header->component_table_size);
+  read_array(fc.directory_table, header->directory_table_size);
+  read_array(fc.key_table, header->key_table_size);
+  read_array(fc.free_files, header->free_file_count);
+  fc.strings.assign(cursor, header->arena_size);
+  fc.live_keys = header->live_keys;
+  fc.live_files = header->live_files;
+
+  // ids are followed without checks later on, anything out of range means the file is damaged
+  auto span_valid = [&fc](FileCache::Span span) { return (uint64_t)span.offset + span.length <= fc.strings.size(); };
+  auto id_valid = [](uint32_t id, size_t count) { return id == NO_ID || id < count; };
+  auto table_valid = [](const std::vector<uint32_t>& table, size_t count) {
+    if (!table.empty() && !is_power_of_two(table.size())) {
+      return false;
+    }
+    return std::all_of(table.begin(), table.end(), [count](uint32_t value) { return value <= count; });
+  };
+
+  bool valid =
+    std::all_of(fc.components.begin(), fc.components.end(), span_valid) &&
+    std::all_of(fc.directories.begin(), fc.directories.end(), [&](const FileCache::Directory& directory) {
+        return id_valid(directory.parent, fc.directories.size()) && directory.name < fc.components.size();
+        }) &&
+    std::all_of(fc.files.begin(), fc.files.end(), [&](const FileCache::File& file) {
+        return file.directory == NO_ID || (file.directory < fc.directories.size() && file.name < fc.components.size() &&
+            file.key < fc.keys.size() && file.cartridge < fc.components.size() && id_valid(file.next, fc.files.size()));
+        }) &&
+    std::all_of(fc.keys.begin(), fc.keys.end(), [&](const FileCache::Key& key) {
+        return span_valid(key.name) && id_valid(key.head, fc.files.size());
+        }) &&
+    std::all_of(fc.free_files.begin(), fc.free_files.end(), [&](uint32_t id) { return id < fc.files.size(); }) &&
+    table_valid(fc.component_table, fc.components.size()) &&
+    table_valid(fc.directory_table, fc.directories.size()) &&
+    table_valid(fc.key_table, fc.keys.size());
+  if (!valid) {
+    return invalid();
+  }
+
+  // the trie is cheap to rebuild and not worth a place in the file
+  for (const auto& key : fc.keys) {
+    if (key.count > 0) {
+      fc.module_trie.insert(fc.view(key.name));
+    }
+  }
+
+  munmap(mapping, size);
+  return index;
+}
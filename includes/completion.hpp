@@ -0,0 +1,58 @@
+#ifndef SFCC_COMPLETION_HPP_
+#define SFCC_COMPLETION_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lsp {
+  // one entry of the generated table in items.hpp, `json` is the CompletionItem already serialized
+  struct CompletionEntry {
+    std::string_view label;
+    // carries the insertText as well
+    std::string_view json;
+  };
+
+  // filters the completion entries down to the best few for the word being typed.
+  // entries are sorted by their lowercased label once, and a trie over those labels maps every
+  // prefix to the contiguous range of entries starting with it. prefix matches rank first,
+  // everything else is scored as a fuzzy subsequence match.
+  class CompletionEngine {
+    private:
+      struct TrieNode {
+        char c;
+        // children are stored next to each other, sorted by character
+        uint32_t first_child;
+        uint32_t child_count;
+        // entries below this node, as a range of the sorted entries
+        uint32_t begin;
+        uint32_t end;
+      };
+
+      std::vector<const CompletionEntry*> entries;
+      std::vector<std::string> folded;
+      std::vector<TrieNode> nodes;
+      size_t limit;
+
+      void build(uint32_t node, size_t depth);
+      std::pair<uint32_t, uint32_t> prefix_range(std::string_view prefix) const;
+
+    public:
+      CompletionEngine(std::span<const CompletionEntry> entries, size_t limit = 50);
+
+      // the serialized CompletionList, put together from the pre-serialized entries
+      std::string complete(std::string_view word) const;
+
+      // the identifier characters right before `column`
+      static std::string_view word_before(std::string_view line, size_t column);
+      // what was typed so far of the string argument of a `require(` call the column is in
+      static std::optional<std::string_view> require_argument_before(std::string_view line, size_t column);
+      // nothing when `pattern` is not a subsequence of the label, higher is better otherwise
+      static std::optional<int> fuzzy_score(std::string_view pattern, std::string_view label, std::string_view folded);
+  };
+}
+
+#endif // SFCC_COMPLETION_HPP_
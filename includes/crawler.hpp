@@ -0,0 +1,74 @@
+#ifndef SFCC_CRAWLER_HPP_
+#define SFCC_CRAWLER_HPP_
+
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <file_cache.hpp>
+
+namespace lsp {
+  // more threads only fight over the disk
+  const size_t MAX_CRAWLER_THREADS = 64;
+
+  // walks the workspace with a fixed number of threads. every worker owns a deque of
+  // directories, takes work from its back and steals from the front of the others when
+  // it runs dry, so deep and wide trees keep all threads busy.
+  class Crawler {
+    private:
+      struct WorkItem {
+        std::filesystem::path path;
+        // `/cartridge/...` prefix of the directory, empty until a `cartridge` directory is entered
+        std::string key;
+      };
+
+      // files of one directory below a `cartridge` directory, interned once the walk is over
+      struct Listing {
+        std::string directory;
+        std::string key;
+        std::vector<std::string> files;
+      };
+
+      // everything one worker found, only ever touched by that worker
+      struct WorkerResult {
+        workspace::cartridges cartridges;
+        std::vector<DirectoryStamp> directories;
+        std::vector<Listing> listings;
+      };
+
+      struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<WorkItem> items;
+      };
+
+      size_t thread_count;
+      std::vector<std::unique_ptr<WorkerQueue>> queues;
+      // directories queued or being processed, the crawl is over when it drops to zero
+      std::atomic<size_t> pending;
+      // bumped on every push and once the crawl is over, idle workers wait on it instead of spinning
+      std::atomic<uint32_t> pushes;
+      std::atomic<size_t> visited;
+      std::function<void(size_t)> on_progress;
+
+      bool pop(size_t worker, WorkItem& item);
+      void push(size_t worker, WorkItem item);
+      void work(size_t worker, WorkerResult& result);
+      void process(size_t worker, const WorkItem& item, WorkerResult& result);
+
+    public:
+      Crawler(size_t thread_count);
+
+      // thread count from SFCC_LSP_CRAWLER_THREADS, falls back to the number of cores
+      static size_t default_thread_count();
+
+      // `on_progress` is called every now and then with the number of directories visited so far,
+      // from whichever worker thread crossed the mark
+      FileIndex crawl(const std::string& root, std::function<void(size_t)> on_progress = nullptr);
+  };
+}
+
+#endif // SFCC_CRAWLER_HPP_
@@ -0,0 +1,61 @@
+#ifndef SFCC_DISPATCHER_HPP_
+#define SFCC_DISPATCHER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lsp {
+  // set once the client cancelled the request or a newer one made it pointless
+  typedef std::shared_ptr<std::atomic<bool>> CancelToken;
+
+  // runs read-only requests on a pool of worker threads. everything that changes documents stays on
+  // the main thread, requests are handed their own snapshot of whatever they read before they are queued.
+  class Dispatcher {
+    private:
+      struct Job {
+        std::string id;
+        CancelToken cancelled;
+        std::function<void(const CancelToken&)> run;
+      };
+
+      size_t thread_count;
+      std::vector<std::thread> threads;
+      std::mutex mutex;
+      std::condition_variable cv;
+      std::deque<Job> jobs;
+      bool stopping = false;
+      // request id -> token of every request queued or running
+      std::map<std::string, CancelToken> in_flight;
+      // supersede key -> id of the newest request submitted with it
+      std::map<std::string, std::string> latest;
+
+      void work();
+
+    public:
+      Dispatcher(size_t thread_count);
+      Dispatcher(const Dispatcher&) = delete;
+      Dispatcher& operator=(const Dispatcher&) = delete;
+      ~Dispatcher();
+
+      // thread count from SFCC_LSP_REQUEST_THREADS, falls back to the number of cores
+      static size_t default_thread_count();
+
+      // `id` is the serialized request id. a request with the same non empty `supersede_key` as an
+      // earlier one cancels it, the client only cares about the answer for where the cursor is now.
+      // `run` is always called, also for cancelled requests, so it can answer them
+      void submit(std::string id, std::string supersede_key, std::function<void(const CancelToken&)> run);
+      void cancel(const std::string& id);
+      // drops everything still queued and waits for the running requests, called before shutdown
+      void stop();
+  };
+}
+
+#endif // SFCC_DISPATCHER_HPP_
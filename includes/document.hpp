@@ -0,0 +1,98 @@
+#ifndef SFCC_DOCUMENT_HPP_
+#define SFCC_DOCUMENT_HPP_
+
+#include <tree_sitter/api.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lsp {
+  struct Position;
+  struct Range;
+
+  // lsp positions count utf-16 code units, everything in here works on utf-8 bytes
+  size_t utf16_length(std::string_view text);
+  // byte offset of the first `units` utf-16 code units of `text`, a unit halfway through a character stays before it
+  size_t utf16_offset(std::string_view text, size_t units);
+
+  // a top level or nested variable declarator, or a function declaration
+  struct Symbol {
+    // bytes of the whole declarator, `a = require('...')`
+    size_t start;
+    size_t end;
+    // bytes of the declared name
+    size_t name_start;
+    size_t name_end;
+    // `*/cartridge/...` when the value is a require call, empty otherwise
+    std::string require;
+  };
+
+  // declared name -> its first declaration in the document
+  typedef std::unordered_map<std::string, Symbol> SymbolTable;
+
+  // a span of one of the immutable buffers that make up the document
+  struct Piece {
+    std::shared_ptr<const std::string> buffer;
+    size_t offset;
+    size_t length;
+  };
+
+  // piece table backed text document. edits never touch the existing buffers,
+  // they only split pieces and append a new buffer holding the inserted text,
+  // so applying a ranged change costs O(edit) plus a shift of the line index.
+  class Document {
+    private:
+      std::vector<Piece> pieces;
+      // byte offset of the first character of every line
+      std::vector<size_t> line_starts;
+      size_t length = 0;
+      int version = 0;
+      // syntax tree of the current contents, kept in sync through ts_tree_edit and reparsed incrementally
+      TSTree* tree = nullptr;
+      // built from the tree on first use and dropped with every change, copies share it
+      std::shared_ptr<const SymbolTable> symbols;
+
+      size_t split_at(size_t offset);
+      void compact();
+
+    public:
+      Document() : line_starts({0}) {};
+      Document(std::string text, int version);
+      Document(const Document& other);
+      Document(Document&& other) noexcept;
+      Document& operator=(Document other) noexcept;
+      ~Document();
+
+      void replace(std::string text);
+      void apply_change(const Range& range, std::string text);
+
+      // positions are in utf-16 code units, as the client sends them
+      size_t offset_at(const Position& position) const;
+      Position position_at(size_t offset) const;
+      // row and byte column, the way tree-sitter wants them
+      TSPoint point_at(size_t offset) const;
+
+      std::string text() const;
+      std::string text(size_t start, size_t end) const;
+      // the line without its newline. it points straight into the buffers unless the line is split
+      // across pieces, only then it is put together in `scratch`. valid until the next change
+      std::string_view line_view(size_t line, std::string& scratch) const;
+      std::string line(size_t line) const;
+
+      size_t size() const { return this->length; }
+      size_t line_count() const { return this->line_starts.size(); }
+      int get_version() const { return this->version; }
+      void set_version(int version) { this->version = version; }
+
+      const std::vector<Piece>& get_pieces() const { return this->pieces; }
+      TSTree* get_tree() const { return this->tree; }
+      void set_tree(TSTree* tree);
+
+      const std::shared_ptr<const SymbolTable>& get_symbols() const { return this->symbols; }
+      void set_symbols(std::shared_ptr<const SymbolTable> symbols) { this->symbols = std::move(symbols); }
+  };
+}
+
+#endif // SFCC_DOCUMENT_HPP_
@@ -0,0 +1,51 @@
+#ifndef SFCC_EXPORT_INDEX_HPP_
+#define SFCC_EXPORT_INDEX_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lsp {
+  // where an exported name is written, names never span lines. columns are utf-16 code units
+  struct Export {
+    uint32_t line;
+    uint32_t start;
+    uint32_t end;
+    // where a definition lands, the declaration of the variable or function assigned to it when
+    // that is a plain identifier, `{ calc: calc }`, and the name itself otherwise
+    uint32_t target_line;
+    uint32_t target_start;
+    uint32_t target_end;
+  };
+
+  // exported name -> the property assigned to it, from `module.exports = { ... }`,
+  // `module.exports.x = ...` and `exports.x = ...`
+  typedef std::unordered_map<std::string, Export> ModuleExports;
+
+  // the exports of every module in the workspace by absolute path. filled in the background
+  // once the file cache is there and kept up to date from the file events, so a definition
+  // can point at a member without opening the module it lives in.
+  class ExportIndex {
+    private:
+      mutable std::shared_mutex mutex;
+      std::unordered_map<std::string, ModuleExports> modules;
+
+    public:
+      // `replace` false keeps what is there, the initial build must not undo a newer file event
+      void set(const std::string& path, ModuleExports exports, bool replace = true);
+      void remove(const std::string& path);
+      void remove_under(const std::vector<std::string>& directories);
+      void clear();
+
+      std::optional<Export> find(const std::string& path, std::string_view name) const;
+      std::optional<ModuleExports> get(const std::string& path) const;
+      bool contains(const std::string& path) const;
+      size_t size() const;
+  };
+}
+
+#endif // SFCC_EXPORT_INDEX_HPP_
@@ -0,0 +1,155 @@
+#ifndef SFCC_FILE_CACHE_HPP_
+#define SFCC_FILE_CACHE_HPP_
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <workspace.hpp>
+#include <module_trie.hpp>
+
+namespace lsp {
+  // cartridge name -> position on the site cartridge path, earlier cartridges override later ones
+  typedef std::map<std::string, size_t, std::less<>> CartridgeRanks;
+
+  CartridgeRanks cartridge_ranks(const std::vector<std::string>& cartridge_path);
+  // name of the cartridge a file belongs to, the directory holding its innermost `cartridge` directory
+  std::string cartridge_name(const std::string& path);
+
+  const uint32_t NO_ID = UINT32_MAX;
+
+  struct FileIndex;
+
+  // `/cartridge/...` key -> every file in the workspace providing that module.
+  //
+  // paths are never stored whole. every path component is interned once into a shared arena,
+  // directories are (parent, component) pairs and files are (directory, component) pairs, so
+  // a file costs a handful of ids. keys live in the same arena and are found through open
+  // addressing tables, each key heading a linked list of its file ids.
+  //
+  // that list is kept as a resolution chain: the file that wins comes first, followed by the
+  // ones it overrides. cartridges that are not on the path go last, by name.
+  class FileCache {
+    public:
+      struct Span {
+        uint32_t offset;
+        uint32_t length;
+      };
+
+      struct Directory {
+        // NO_ID for directories directly below `/`
+        uint32_t parent;
+        uint32_t name;
+      };
+
+      struct File {
+        // NO_ID once the file is removed, the slot is reused by the next file added
+        uint32_t directory;
+        uint32_t name;
+        uint32_t key;
+        // component id of the cartridge name
+        uint32_t cartridge;
+        uint32_t next;
+      };
+
+      struct Key {
+        Span name;
+        uint32_t head;
+        uint32_t count;
+      };
+
+    private:
+      std::string strings;
+      std::vector<Span> components;
+      std::vector<Directory> directories;
+      std::vector<File> files;
+      std::vector<Key> keys;
+      // slots hold id + 1, zero marks an empty slot. sizes are always a power of two
+      std::vector<uint32_t> component_table;
+      std::vector<uint32_t> directory_table;
+      std::vector<uint32_t> key_table;
+      std::vector<uint32_t> free_files;
+      uint32_t live_keys = 0;
+      uint32_t live_files = 0;
+      CartridgeRanks ranks;
+      // every live key, kept in step by link and unlink
+      ModuleTrie module_trie;
+
+      std::string_view view(Span span) const { return std::string_view(this->strings).substr(span.offset, span.length); }
+      Span add_string(std::string_view str);
+
+      uint32_t find_component(std::string_view name) const;
+      uint32_t intern_component(std::string_view name);
+      uint32_t find_directory(uint32_t parent, uint32_t name) const;
+      uint32_t intern_directory(uint32_t parent, uint32_t name);
+      uint32_t lookup_directory(std::string_view path) const;
+      uint32_t find_key(std::string_view key) const;
+      uint32_t intern_key(std::string_view key);
+
+      size_t file_rank(uint32_t file) const;
+      bool chain_less(uint32_t a, uint32_t b) const;
+      void link(uint32_t file);
+      void unlink(uint32_t file);
+
+      friend bool save_file_index(const std::filesystem::path&, const std::string&, const FileIndex&);
+      friend std::optional<FileIndex> load_file_index(const std::filesystem::path&, const std::string&);
+
+    public:
+      // interns an absolute directory path, the files inside of it then only add their own name
+      uint32_t add_directory(std::string_view path);
+      bool add_file(uint32_t directory, std::string_view name, std::string_view key);
+      bool add(const std::string& path);
+      bool remove(const std::string& path);
+      // drops every file below any of the directories in one pass, returns how many went away
+      size_t remove_under(const std::vector<std::string>& directories);
+
+      // reorders every resolution chain, files added afterwards are inserted in order
+      void set_ranks(const CartridgeRanks& ranks);
+
+      // absolute paths providing the key, in resolution order
+      std::vector<std::string> lookup(std::string_view key) const;
+      std::string directory_path(uint32_t directory) const;
+      std::string path(uint32_t file) const;
+      // every file in the cache
+      std::vector<std::string> paths() const;
+      const ModuleTrie& modules() const { return this->module_trie; }
+
+      // number of keys
+      size_t size() const { return this->live_keys; }
+      size_t file_count() const { return this->live_files; }
+  };
+
+  // a directory walked while building the cache together with its modification time.
+  // creating, deleting or renaming an entry bumps the mtime of the containing directory,
+  // so comparing these is enough to tell whether a stored cache is still valid.
+  struct DirectoryStamp {
+    std::string path;
+    int64_t mtime;
+  };
+
+  std::optional<int64_t> directory_mtime(const std::string& path);
+  // vcs, dependency and test directories are never indexed
+  bool is_forbidden_path(const std::string& path);
+  // `/cartridge/...` key of a file, taken from the innermost `cartridge` directory
+  std::optional<std::string> cartridge_key(const std::string& path);
+
+  // everything learned from one walk over the workspace
+  struct FileIndex {
+    FileCache fc;
+    workspace::cartridges cartridges;
+    std::vector<DirectoryStamp> directories;
+  };
+
+  // on-disk format is versioned, bump this whenever the layout changes
+  const uint32_t FILE_INDEX_VERSION = 3;
+
+  std::filesystem::path file_index_path(const std::filesystem::path& data_dir, const std::string& root);
+  bool save_file_index(const std::filesystem::path& index_path, const std::string& root, const FileIndex& index);
+  // returns nothing when there is no index, it is from another version or root, or any directory changed since
+  std::optional<FileIndex> load_file_index(const std::filesystem::path& index_path, const std::string& root);
+}
+
+#endif // SFCC_FILE_CACHE_HPP_
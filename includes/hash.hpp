@@ -0,0 +1,18 @@
+#ifndef SFCC_HASH_HPP_
+#define SFCC_HASH_HPP_
+
+#include <cstdint>
+#include <string_view>
+
+namespace lsp {
+  // FNV-1a, constexpr so it can be used for switch labels as well
+  constexpr uint64_t fnv1a(std::string_view str, uint64_t hash = 14695981039346656037ull) {
+    for (char c : str) {
+      hash ^= (unsigned char)c;
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+}
+
+#endif // SFCC_HASH_HPP_
@@ -0,0 +1,83 @@
+#ifndef SFCC_LOGGER_HPP_
+#define SFCC_LOGGER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace lsp {
+  enum LogLevel {
+    LOG_OFF = 0,
+    LOG_ERROR = 1,
+    LOG_INFO = 2,
+    LOG_DEBUG = 3,
+    // every message body, only meant for debugging a client
+    LOG_TRACE = 4,
+  };
+
+  std::optional<LogLevel> parse_log_level(std::string_view name);
+
+  // log lines are handed over through a bounded lock-free queue and written by a background
+  // thread, so logging never blocks the thread doing it. when the queue is full lines are
+  // dropped and counted instead. messages are cut to a maximum size before they are copied,
+  // and the file is rotated once it gets too big.
+  class Logger {
+    private:
+      struct Record {
+        LogLevel level;
+        std::chrono::system_clock::time_point time;
+        std::string message;
+      };
+
+      struct Slot {
+        // bounded MPMC queue by Dmitry Vyukov, the sequence tells producers and the consumer whose turn it is
+        std::atomic<size_t> sequence;
+        Record record;
+      };
+
+      std::unique_ptr<Slot[]> slots;
+      size_t mask;
+      std::atomic<size_t> enqueue_position = 0;
+      size_t dequeue_position = 0;
+      std::atomic<uint32_t> wakeups = 0;
+      std::atomic<size_t> dropped = 0;
+
+      std::atomic<int> level;
+      std::atomic<size_t> max_message_size;
+      std::atomic<size_t> max_file_size;
+
+      std::string path;
+      int fd = -1;
+      size_t file_size = 0;
+      std::atomic<bool> stopping = false;
+      std::thread thread;
+
+      bool push(Record&& record);
+      bool pop(Record& record);
+      void run();
+      void write_out(const std::string& batch);
+      void rotate();
+
+    public:
+      Logger();
+      Logger(const Logger&) = delete;
+      Logger& operator=(const Logger&) = delete;
+      ~Logger();
+
+      // starts writing to `path`, nothing is opened before the first line actually has to be written
+      void start(const std::string& path);
+      void configure(std::optional<LogLevel> level, std::optional<size_t> max_message_size, std::optional<size_t> max_file_size);
+
+      // callers building expensive messages check this first, with logging off nothing else happens
+      bool enabled(LogLevel level) const { return level <= this->level.load(std::memory_order_relaxed); }
+      void log(LogLevel level, std::string_view message);
+      // `prefix` followed by `message`, put together only after the message was cut
+      void log(LogLevel level, std::string_view prefix, std::string_view message);
+  };
+}
+
+#endif // SFCC_LOGGER_HPP_
@@ -1,13 +1,29 @@
 #ifndef SFCC_LSP_HPP_
 #define SFCC_LSP_HPP_
 
+#include <atomic>
 #include <cerrno>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <string>
 #include <ranges>
 #include <glob.h>
 #include <nlohmann/json.hpp>
 #include <treesitter.hpp>
+#include <document.hpp>
+#include <file_cache.hpp>
+#include <watcher.hpp>
+#include <transport.hpp>
+#include <dispatcher.hpp>
+#include <logger.hpp>
+#include <completion.hpp>
+#include <export_index.hpp>
+#include <require_graph.hpp>
+#include <module_index.hpp>
 using json = nlohmann::json;
 
 namespace lsp {
@@ -29,12 +45,6 @@ namespace lsp {
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(Location, uri, range);
   };
 
-  struct CompletionItem {
-    std::string label;
-    std::string insertText;
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(CompletionItem, label, insertText);
-  };
-
   struct Message {
       std::string jsonrpc = "2.0";
   };
@@ -44,7 +54,16 @@ namespace lsp {
     public:
       std::string method;
       T params;
-      NLOHMANN_DEFINE_TYPE_INTRUSIVE(NotificationMessage, method, params);
+      NLOHMANN_DEFINE_TYPE_INTRUSIVE(NotificationMessage, jsonrpc, method, params);
+  };
+
+  template <typename T>
+  class RequestMessage : public Message {
+    public:
+      std::string id;
+      std::string method;
+      T params;
+      NLOHMANN_DEFINE_TYPE_INTRUSIVE(RequestMessage, jsonrpc, id, method, params);
   };
 
   template <typename T>
@@ -54,7 +73,52 @@ namespace lsp {
       T result;
 
     ResponseMessage(int id, T result) : id(id), result(result) {};
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(ResponseMessage, id, result);
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(ResponseMessage, jsonrpc, id, result);
+  };
+
+  // json-rpc error codes
+  const int INVALID_REQUEST = -32600;
+  const int INVALID_PARAMS = -32602;
+  const int REQUEST_CANCELLED = -32800;
+
+  struct ResponseError {
+    int code;
+    std::string message;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(ResponseError, code, message);
+  };
+
+  class ErrorResponseMessage : public Message {
+    public:
+      json id;
+      ResponseError error;
+      NLOHMANN_DEFINE_TYPE_INTRUSIVE(ErrorResponseMessage, jsonrpc, id, error);
+  };
+
+  struct TextEdit {
+    Range range;
+    std::string newText;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(TextEdit, range, newText);
+  };
+
+  // completion item kinds
+  const int COMPLETION_KIND_MODULE = 9;
+  const int COMPLETION_KIND_FOLDER = 19;
+
+  // the dw api items are serialized ahead of time, see items.hpp. these are the ones built per request
+  struct CompletionItem {
+    std::string label;
+    int kind;
+    std::string detail;
+    // keeps the order of the server, clients sort by label otherwise
+    std::string sortText;
+    TextEdit textEdit;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(CompletionItem, label, kind, detail, sortText, textEdit);
+  };
+
+  struct CompletionList {
+    bool isIncomplete;
+    std::vector<CompletionItem> items;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(CompletionList, isIncomplete, items);
   };
 
   struct ServerInfo {
@@ -65,14 +129,24 @@ namespace lsp {
 
   struct CompletionProvider {
       bool resolveProvider = false;
-      NLOHMANN_DEFINE_TYPE_INTRUSIVE(CompletionProvider, resolveProvider);
+      // quotes and slashes move through a require path, see handle_require_completion
+      std::vector<std::string> triggerCharacters = {"'", "\"", "/"};
+      NLOHMANN_DEFINE_TYPE_INTRUSIVE(CompletionProvider, resolveProvider, triggerCharacters);
   };
 
   struct Capabilities {
     CompletionProvider completionProvider;
-    int textDocumentSync = 1;
+    // incremental, the client only sends the ranges that changed
+    int textDocumentSync = 2;
     bool definitionProvider = true;
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(Capabilities, completionProvider, textDocumentSync, definitionProvider);
+    // lists every override of a module along the cartridge path, definition only jumps to the winner
+    bool implementationProvider = true;
+    // modules and exported members, from the require graph
+    bool referencesProvider = true;
+    bool callHierarchyProvider = true;
+    // functions, top level variables and exports of every module
+    bool workspaceSymbolProvider = true;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(Capabilities, completionProvider, textDocumentSync, definitionProvider, implementationProvider, referencesProvider, callHierarchyProvider, workspaceSymbolProvider);
   };
 
   class InitializeResult {
@@ -84,43 +158,88 @@ namespace lsp {
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(InitializeResult, serverInfo, capabilities);
   };
 
-  class CompletionList {
-    public:
-      bool isIncomplete;
-      std::vector<CompletionItem> items;
-
-      CompletionList(bool isIncomplete, std::vector<CompletionItem> items): isIncomplete(isIncomplete), items(items) {};
-      NLOHMANN_DEFINE_TYPE_INTRUSIVE(CompletionList, isIncomplete, items);
-  };
-
   struct TextDocument {
       std::string uri;
       int version;
       NLOHMANN_DEFINE_TYPE_INTRUSIVE(TextDocument, uri, version);
   };
 
-  struct TextDocumentContentChangeEvent {
-      std::string text;
-      NLOHMANN_DEFINE_TYPE_INTRUSIVE(TextDocumentContentChangeEvent, text);
+  struct TextDocumentIdentifier {
+    std::string uri;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(TextDocumentIdentifier, uri);
   };
 
-  struct TextDocumentItem {
-    std::string uri;
-    std::string languageId;
-    int version;
-    std::string text;
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(TextDocumentItem, uri, languageId, version, text);
+  struct TextDocumentPositionParams {
+    TextDocumentIdentifier textDocument;
+    Position position;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(TextDocumentPositionParams, textDocument, position);
+  };
+
+  struct DidCloseTextDocumentParams {
+    TextDocumentIdentifier textDocument;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(DidCloseTextDocumentParams, textDocument);
+  };
+
+  struct WorkDoneProgressCreateParams {
+    std::string token;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(WorkDoneProgressCreateParams, token);
+  };
+
+  struct WorkDoneProgressBegin {
+    std::string kind = "begin";
+    std::string title;
+    std::string message;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(WorkDoneProgressBegin, kind, title, message);
+  };
+
+  // used for both `report` and `end`
+  struct WorkDoneProgressReport {
+    std::string kind;
+    std::string message;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(WorkDoneProgressReport, kind, message);
   };
 
-  struct DidOpenTextDocumentParams {
-    TextDocumentItem textDocument;
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(DidOpenTextDocumentParams, textDocument);
+  template <typename T>
+  struct ProgressParams {
+    // the client picks the token type when it hands one out, so it is kept as is
+    json token;
+    T value;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(ProgressParams, token, value);
+  };
+
+  struct FileSystemWatcher {
+    std::string globPattern;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(FileSystemWatcher, globPattern);
+  };
+
+  struct DidChangeWatchedFilesRegistrationOptions {
+    std::vector<FileSystemWatcher> watchers;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(DidChangeWatchedFilesRegistrationOptions, watchers);
+  };
+
+  template <typename T>
+  struct Registration {
+    std::string id;
+    std::string method;
+    T registerOptions;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(Registration, id, method, registerOptions);
+  };
+
+  template <typename T>
+  struct RegistrationParams {
+    std::vector<Registration<T>> registrations;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(RegistrationParams, registrations);
   };
 
-  struct DidChangeTextDocumentParams {
-    TextDocument textDocument;
-    std::vector<TextDocumentContentChangeEvent> contentChanges;
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(DidChangeTextDocumentParams, textDocument, contentChanges);
+  struct FileChange {
+    std::string uri;
+    int type;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(FileChange, uri, type);
+  };
+
+  struct DidChangeWatchedFilesParams {
+    std::vector<FileChange> changes;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(DidChangeWatchedFilesParams, changes);
   };
 
   struct CartridgeEntry {
@@ -129,39 +248,201 @@ namespace lsp {
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(CartridgeEntry, file_name, file_path);
   };
 
-  typedef std::map<std::string, std::vector<std::string>> FileCache;
+  // returned instead of the plain list when the client sent an etag. the list is left out
+  // when the etag still matches, so refreshing an unchanged cartridge panel costs next to nothing
+  struct CartridgesResult {
+    std::string etag;
+    bool unchanged;
+    std::vector<CartridgeEntry> cartridges;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(CartridgesResult, etag, unchanged, cartridges);
+  };
+
+  // response for sfcc-lsp/module/dependents, the files a change to the module can break
+  struct ModuleDependents {
+    std::string module;
+    std::vector<std::string> dependents;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(ModuleDependents, module, dependents);
+  };
+
+  // what references and the call hierarchy are asked about, a module by its key or one of its members
+  struct ModuleTarget {
+    std::string key;
+    std::string member;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(ModuleTarget, key, member);
+  };
+
+  struct CallHierarchyItem {
+    std::string name;
+    int kind;
+    std::string detail;
+    std::string uri;
+    Range range;
+    Range selectionRange;
+    // handed back by the client with the incoming and outgoing calls requests
+    ModuleTarget data;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(CallHierarchyItem, name, kind, detail, uri, range, selectionRange, data);
+  };
+
+  struct CallHierarchyIncomingCall {
+    CallHierarchyItem from;
+    std::vector<Range> fromRanges;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(CallHierarchyIncomingCall, from, fromRanges);
+  };
+
+  struct CallHierarchyOutgoingCall {
+    CallHierarchyItem to;
+    std::vector<Range> fromRanges;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(CallHierarchyOutgoingCall, to, fromRanges);
+  };
+
+  struct SymbolInformation {
+    std::string name;
+    int kind;
+    Location location;
+    // the cartridge, the same name shows up in many of them
+    std::string containerName;
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(SymbolInformation, name, kind, location, containerName);
+  };
 
   class LSP {
     private:
-      std::vector<CompletionItem> items;
-      std::map<std::string, std::string> documents;
-      std::optional<std::string> get_document(std::string uri);
+      // declared first, everything else may still log while it shuts down
+      Logger logger;
+
+    public:
+      // the indexer, dispatcher and watcher threads all send, it is declared before them so it outlives them
+      Transport transport;
+
+    private:
+      CompletionEngine completion;
+      std::map<std::string, Document> documents;
+      Document* get_document(const std::string& uri);
       std::string current_path;
+      std::filesystem::path data_dir;
       TreeSitter ts;
-      // @TODO: this should be onto a file so that the lsp does not traverse the files on every attach
-      // this should start handling new files. for now, new files will not be included in the cache,
-      // therefore they will not appear as possible locations
-      FileCache fc;
+      // file cache, cartridges and the directories they were built from. kept up to date by the watcher
+      FileIndex index;
+      size_t crawler_threads = 1;
+      // from initializationOptions.cartridgePath or the cartridgePath of the dw.json in the workspace, empty when neither has one
+      CartridgeRanks cartridge_ranks;
+      void load_cartridge_path(const json& options);
+      // response for sfcc-lsp/workspace/cartridges, rebuilt whenever the cartridge map changes
+      std::vector<CartridgeEntry> cartridge_entries;
+      std::string cartridges_etag;
+      void refresh_cartridges();
+
+      // the index is built on a background thread once the client initialized. definitions wait a
+      // bounded time for it, completion answers right away and asks to be asked again, see lock_index
+      bool initialize_received = false;
+      std::thread indexer;
+      std::shared_mutex index_mutex;
+      std::condition_variable_any index_cv;
+      bool index_ready = false;
+      std::shared_lock<std::shared_mutex> lock_index(bool wait);
+
+      std::mutex progress_mutex;
+      std::optional<json> progress_token;
+      bool client_supports_progress = false;
+      bool progress_running = false;
+      bool progress_begun = false;
+      std::string progress_message;
+      void begin_progress(std::string message);
+      void report_progress(std::string message);
+      void end_progress(std::string message);
+      void activate_progress(json token);
+      void handle_response(const json& response);
+
+      // filled after the file cache from one parse of every module, see build_module_index
+      ExportIndex exports;
+      RequireGraph require_graph;
+      SymbolIndex workspace_symbols;
+      // trees of closed modules, shared by the module pass and every request
+      ParseCache parse_cache;
+      std::atomic<bool> stopping = false;
+      static bool is_module_path(const std::string& path);
+      void index_module(const std::string& path, bool replace);
+      void index_modules(const std::vector<std::string>& paths, bool replace);
+      void build_module_index();
+      // file events only mark the index dirty, `force` writes it regardless of when it was last written
+      void save_modules(bool force);
+      std::mutex modules_save_mutex;
+      std::atomic<bool> modules_dirty = false;
+      std::chrono::steady_clock::time_point modules_saved;
+
+      bool client_supports_watched_files = false;
+      // the client is asked for file changes once inotify falls short, which can only be done after initialized
+      std::mutex watched_files_mutex;
+      bool client_initialized = false;
+      bool watched_files_needed = false;
+      bool watched_files_registered = false;
+      void register_watched_files(bool initialized);
+      void apply_file_events(std::vector<FileEvent> events);
+      void save_index();
+      // read-only requests run here, see dispatch
+      Dispatcher dispatcher;
+      void dispatch(const json& id, std::string supersede_key, std::function<std::optional<std::string>()> handle);
+
+      // declared last, its thread calls back into everything above, the transport included, and has to stop first
+      Watcher watcher;
 
-      std::optional<std::vector<Location>> goto_definition_require_line(std::string line);
+      std::optional<std::vector<Location>> goto_definition_require_line(std::string_view line, bool all_overrides);
+      // `require` is the argument of the require call, `*/cartridge/...`
+      // lands on `member` when the module is known to export it
+      std::optional<std::vector<Location>> goto_required_module(std::string require, bool all_overrides, std::string_view member);
+      Range member_range(const std::string& path, std::string_view member);
 
-      CompletionList handle_completion(json request);
-      std::optional<std::vector<Location>> handle_definition(json request);
-      std::optional<std::vector<CartridgeEntry>> handle_cartridges(json request);
+      // the list comes out of the engine already serialized
+      std::string handle_completion(std::string_view word);
+      // `*/cartridge/...` paths from the file cache, one segment at a time
+      CompletionList handle_require_completion(std::string_view typed, Position cursor);
+      std::optional<std::vector<Location>> handle_definition(const Document& document, Position position, bool all_overrides);
+      std::optional<json> handle_cartridges(const std::optional<std::string>& etag);
+      std::optional<ModuleDependents> handle_dependents(const std::string& uri, bool transitive);
+      // the require path, required variable, member or own export under the cursor
+      std::optional<ModuleTarget> target_at(const Document& document, const std::string& uri, Position position);
+      std::vector<Location> handle_references(const ModuleTarget& target, bool include_declaration);
+      std::optional<CallHierarchyItem> module_item(const ModuleTarget& target);
+      CallHierarchyItem file_item(const std::string& path);
+      std::vector<CallHierarchyIncomingCall> handle_incoming_calls(const CallHierarchyItem& item);
+      std::vector<CallHierarchyOutgoingCall> handle_outgoing_calls(const CallHierarchyItem& item);
+      std::vector<SymbolInformation> handle_workspace_symbol(std::string_view query);
+      // symbols are built on the main thread, every request on this version then shares them
+      std::shared_ptr<const Document> snapshot(Document& document);
 
       std::string to_uri(std::string file_path);
-      void prepare_log_file();
-      void build_file_cache(void);
+      std::string from_uri(std::string uri);
+      void prepare_data_dir();
+      void compile_queries();
+      void configure_logging(const json& options);
+      void start_indexing(const json& params);
+      void build_file_cache(size_t thread_count);
 
     public:
-      std::ofstream log_file;
+      LSP(std::span<const CompletionEntry> completions, std::string current_path);
+      LSP(std::span<const CompletionEntry> completions, std::string current_path, std::map<std::string, std::string> documents);
+      ~LSP() {
+        this->stopping = true;
+        this->dispatcher.stop();
+        if (this->indexer.joinable()) {
+          this->indexer.join();
+        }
+        this->save_modules(true);
+      }
 
-      LSP(std::vector<CompletionItem> items, std::string current_path);
-      LSP(std::vector<CompletionItem> items, std::string current_path, std::map<std::string, std::string> documents);
-      ~LSP() { this->log_file.close(); }
+      // both can be called from any thread
+      void send(const json& message);
+      // sends and logs a response, serializing it only once for both
+      void respond(const json& response);
+      // same for a result that is already serialized
+      void respond_result(const json& id, std::string_view result);
+      void log(LogLevel level, std::string_view message);
+      void log(LogLevel level, std::string_view prefix, std::string_view message);
+      bool log_enabled(LogLevel level) const { return this->logger.enabled(level); }
 
-      std::optional<json> handle_request(json request);
-      void handle_notification(json request);
+      // messages with an id but without a method are responses to the server, see handle_response
+      std::optional<json> handle_request(const json& request);
+      // takes the message over, document text is moved out of it
+      void handle_notification(json&& notification);
   };
 }
 
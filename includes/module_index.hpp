@@ -0,0 +1,35 @@
+#ifndef SFCC_MODULE_INDEX_HPP_
+#define SFCC_MODULE_INDEX_HPP_
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+#include <export_index.hpp>
+#include <require_graph.hpp>
+#include <symbol_index.hpp>
+
+namespace lsp {
+  // everything the module pass learned from one file
+  struct ModuleRecord {
+    std::string path;
+    FileStamp stamp;
+    ModuleExports exports;
+    std::vector<RequireSite> sites;
+    std::vector<Declaration> declarations;
+  };
+
+  std::optional<FileStamp> file_stamp(const std::string& path);
+
+  // on-disk format is versioned, bump this whenever the layout changes
+  const uint32_t MODULE_INDEX_VERSION = 3;
+
+  // stored next to the file index. the records are loaded as they are, the caller compares
+  // their stamps with the files to tell which ones still have to be parsed
+  std::filesystem::path module_index_path(const std::filesystem::path& data_dir, const std::string& root);
+  bool save_module_index(const std::filesystem::path& index_path, const std::string& root, const std::vector<ModuleRecord>& records);
+  // returns nothing when there is no index, it is from another version or root, or it is cut short
+  std::optional<std::vector<ModuleRecord>> load_module_index(const std::filesystem::path& index_path, const std::string& root);
+}
+
+#endif // SFCC_MODULE_INDEX_HPP_
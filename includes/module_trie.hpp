@@ -0,0 +1,61 @@
+#ifndef SFCC_MODULE_TRIE_HPP_
+#define SFCC_MODULE_TRIE_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lsp {
+  struct ModuleCompletion {
+    std::string name;
+    // a directory to go further into, otherwise a module that can be required as is
+    bool directory;
+    // modules below a directory
+    uint32_t modules;
+  };
+
+  struct ModuleCompletions {
+    std::vector<ModuleCompletion> items;
+    bool incomplete = false;
+  };
+
+  // the `.js` modules of the file cache keyed by their path segments below `/cartridge/`, so
+  // `*/cartridge/scripts/helpers/basketHelpers` is four nodes down. completing a require path
+  // only walks the finished segments and then filters the children of the last one, however
+  // many modules the workspace has.
+  class ModuleTrie {
+    private:
+      struct Node {
+        std::string name;
+        std::string folded;
+        uint32_t parent;
+        // sorted by (folded, name)
+        std::vector<uint32_t> children;
+        // modules at or below the node, zero once it is unused and waiting in free_nodes
+        uint32_t modules;
+        // 1 when a module ends right here, it can have children all the same
+        uint32_t terminal;
+      };
+
+      std::vector<Node> nodes;
+      std::vector<uint32_t> free_nodes;
+
+      uint32_t find_child(uint32_t node, std::string_view name) const;
+      uint32_t add_child(uint32_t node, std::string_view name);
+
+    public:
+      ModuleTrie();
+
+      // both take a file cache key, `/cartridge/a/b.js`. other extensions are ignored
+      void insert(std::string_view key);
+      void remove(std::string_view key);
+      void clear();
+
+      // children of `directory`, a `/` separated path below `/cartridge/`, that match `partial`. prefix
+      // matches come first and the rest is matched fuzzily, at most `limit` of them.
+      ModuleCompletions complete(std::string_view directory, std::string_view partial, size_t limit) const;
+  };
+}
+
+#endif // SFCC_MODULE_TRIE_HPP_
@@ -0,0 +1,53 @@
+#ifndef SFCC_PARSE_CACHE_HPP_
+#define SFCC_PARSE_CACHE_HPP_
+
+#include <tree_sitter/api.h>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace lsp {
+  // a file from disk together with its syntax tree. the tree is read only, any number of threads can walk it
+  struct ParsedFile {
+    std::string path;
+    std::string source;
+    TSTree* tree;
+    int64_t mtime;
+    // source plus an estimate for the tree, what the cache budget is counted in
+    size_t bytes;
+
+    ParsedFile(std::string path, std::string source, TSTree* tree, int64_t mtime);
+    ParsedFile(const ParsedFile&) = delete;
+    ParsedFile& operator=(const ParsedFile&) = delete;
+    ~ParsedFile() { ts_tree_delete(this->tree); }
+  };
+
+  // trees of closed files, keyed by path and checked against the mtime and size on every lookup.
+  // the least recently used ones are dropped to stay under the byte budget, a tree still in use
+  // by a request lives on until that request lets go of it.
+  class ParseCache {
+    private:
+      mutable std::mutex mutex;
+      size_t budget;
+      size_t used = 0;
+      // most recently used first
+      std::list<std::shared_ptr<const ParsedFile>> lru;
+      std::unordered_map<std::string, std::list<std::shared_ptr<const ParsedFile>>::iterator> entries;
+
+      void evict();
+
+    public:
+      ParseCache(size_t budget);
+
+      // nothing when the file cannot be read. one over the budget by itself is parsed but not kept
+      std::shared_ptr<const ParsedFile> get(const std::string& path);
+      void invalidate(const std::string& path);
+      void set_budget(size_t budget);
+      size_t size() const;
+  };
+}
+
+#endif // SFCC_PARSE_CACHE_HPP_
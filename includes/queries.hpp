@@ -0,0 +1,73 @@
+#ifndef SFCC_QUERIES_HPP_
+#define SFCC_QUERIES_HPP_
+
+#include <tree_sitter/api.h>
+#include <array>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lsp {
+  enum QueryId {
+    QUERY_REQUIRE_LINE,
+    QUERY_MEMBER_EXPRESSION,
+    QUERY_VARIABLE_DECLARATION,
+    QUERY_EXPORT_ASSIGNMENT,
+    QUERY_REQUIRE_CALL,
+    QUERY_COUNT,
+  };
+
+  // capture indices never change after compilation, so they are resolved once
+  // and the match loops compare plain integers
+  const uint32_t NO_CAPTURE = UINT32_MAX;
+
+  struct CompiledQuery {
+    TSQuery* query = nullptr;
+    std::vector<std::string> capture_names;
+
+    uint32_t capture_id(std::string_view name) const;
+  };
+
+  // every query is compiled once for the whole process, when the LSP starts. TSQuery objects are immutable
+  // and can be shared, cursors carry the per-execution state and are pooled instead of
+  // being created for every request.
+  class QueryRegistry {
+    private:
+      std::array<CompiledQuery, QUERY_COUNT> queries;
+      std::vector<std::string> compile_errors;
+      std::vector<TSQueryCursor*> cursors;
+      std::mutex cursors_mutex;
+
+      QueryRegistry();
+
+    public:
+      QueryRegistry(const QueryRegistry&) = delete;
+      QueryRegistry& operator=(const QueryRegistry&) = delete;
+      ~QueryRegistry();
+
+      static QueryRegistry& instance();
+
+      const CompiledQuery& get(QueryId id) const { return this->queries[id]; }
+      // one message for every query that did not compile, those are left null
+      const std::vector<std::string>& errors() const { return this->compile_errors; }
+
+      TSQueryCursor* acquire_cursor();
+      void release_cursor(TSQueryCursor* cursor);
+  };
+
+  class PooledCursor {
+    private:
+      TSQueryCursor* cursor;
+
+    public:
+      PooledCursor() : cursor(QueryRegistry::instance().acquire_cursor()) {};
+      PooledCursor(const PooledCursor&) = delete;
+      PooledCursor& operator=(const PooledCursor&) = delete;
+      ~PooledCursor() { QueryRegistry::instance().release_cursor(this->cursor); }
+
+      TSQueryCursor* get() const { return this->cursor; }
+  };
+}
+
+#endif // SFCC_QUERIES_HPP_
@@ -0,0 +1,94 @@
+#ifndef SFCC_REQUIRE_GRAPH_HPP_
+#define SFCC_REQUIRE_GRAPH_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lsp {
+  // `helpers.calc` of `var helpers = require(...)`, `require(...).calc` and `var { calc } = require(...)`,
+  // the range is the member name
+  struct MemberUse {
+    std::string name;
+    uint32_t line;
+    uint32_t start;
+    uint32_t end;
+  };
+
+  // one `require('...')` call, the range is the path inside of the quotes. columns are utf-16 code units
+  struct RequireSite {
+    std::string specifier;
+    uint32_t line;
+    uint32_t start;
+    uint32_t end;
+    std::vector<MemberUse> members;
+  };
+
+  // what a file looked like when it was parsed, a stored graph is only trusted for unchanged files
+  struct FileStamp {
+    int64_t mtime;
+    uint64_t size;
+    bool operator==(const FileStamp&) const = default;
+  };
+
+  // a require path or member use somewhere in the workspace
+  struct Reference {
+    std::string path;
+    uint32_t line;
+    uint32_t start;
+    uint32_t end;
+  };
+
+  struct Dependency {
+    // see RequireGraph::module_key
+    std::string key;
+    RequireSite site;
+  };
+
+  // which module every workspace file requires and, the other way around, which files require a module.
+  // modules are identified by the same `/cartridge/...` keys as the file cache, whatever cartridge ends
+  // up providing them, so the files requiring `*/cartridge/scripts/x` all depend on `/cartridge/scripts/x.js`.
+  class RequireGraph {
+    private:
+      mutable std::shared_mutex mutex;
+      struct Requires {
+        FileStamp stamp;
+        // in source order
+        std::vector<Dependency> dependencies;
+      };
+      // absolute path -> its requires
+      std::unordered_map<std::string, Requires> forward;
+      // module key -> absolute paths of the files requiring it
+      std::unordered_map<std::string, std::set<std::string>> reverse;
+
+      void unlink(const std::string& path);
+
+    public:
+      // `*/cartridge/a` and `~/cartridge/a` -> `/cartridge/a.js`, relative paths are resolved against
+      // the requiring file first. anything else, the dw api and plain packages, is kept as written
+      static std::string module_key(const std::string& from, std::string_view specifier);
+
+      // `replace` false keeps what is there, the initial build must not undo a newer file event
+      void set(const std::string& path, FileStamp stamp, std::vector<RequireSite> sites, bool replace = true);
+      void remove(const std::string& path);
+      void remove_under(const std::vector<std::string>& directories);
+      void clear();
+
+      std::vector<Dependency> dependencies(const std::string& path) const;
+      // files requiring the module. `transitive` follows them up to everything the module can affect
+      std::vector<std::string> dependents(const std::string& key, bool transitive) const;
+      // the require paths pointing at the module, or with `member` every use of that member through them
+      std::vector<Reference> references(const std::string& key) const;
+      std::vector<Reference> member_references(const std::string& key, std::string_view member) const;
+      // every file with its requires, under the shared lock. for writing the graph to disk
+      void for_each(const std::function<void(const std::string&, const FileStamp&, const std::vector<Dependency>&)>& visit) const;
+      size_t size() const;
+  };
+}
+
+#endif // SFCC_REQUIRE_GRAPH_HPP_
@@ -0,0 +1,76 @@
+#ifndef SFCC_SYMBOL_INDEX_HPP_
+#define SFCC_SYMBOL_INDEX_HPP_
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lsp {
+  // symbol kinds
+  const int SYMBOL_KIND_MODULE = 2;
+  const int SYMBOL_KIND_PROPERTY = 7;
+  const int SYMBOL_KIND_FUNCTION = 12;
+  const int SYMBOL_KIND_VARIABLE = 13;
+
+  // a function, top level variable or export of a file. columns are utf-16 code units
+  struct Declaration {
+    std::string name;
+    int kind;
+    uint32_t line;
+    uint32_t start;
+    uint32_t end;
+  };
+
+  struct SymbolMatch {
+    Declaration declaration;
+    std::string path;
+  };
+
+  // the declarations of every module for workspace/symbol. names are lowercased and every three
+  // consecutive characters point back at the names containing them, so a query finds the names it is
+  // a substring of by intersecting a few posting lists. when that gives too few results, the names are
+  // scanned once more for the query as a subsequence.
+  class SymbolIndex {
+    private:
+      static const uint32_t NO_FILE = UINT32_MAX;
+
+      struct Entry {
+        Declaration declaration;
+        std::string folded;
+        // NO_FILE once the file is gone, postings are cleaned up in bulk by compact
+        uint32_t file;
+      };
+
+      mutable std::shared_mutex mutex;
+      std::vector<Entry> entries;
+      // file id -> path and the entries declared in it
+      std::vector<std::string> files;
+      std::vector<std::vector<uint32_t>> file_entries;
+      std::unordered_map<std::string, uint32_t> file_ids;
+      // trigram -> ids of the entries containing it, ascending
+      std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+      size_t dead = 0;
+
+      void add(uint32_t file, Declaration declaration);
+      void unlink(uint32_t file);
+      void compact();
+
+    public:
+      // `replace` false keeps what is there, the initial build must not undo a newer file event
+      void set(const std::string& path, std::vector<Declaration> declarations, bool replace = true);
+      void remove(const std::string& path);
+      void remove_under(const std::vector<std::string>& directories);
+      void clear();
+
+      std::vector<Declaration> get(const std::string& path) const;
+      // best matches first, at most `limit` of them
+      std::vector<SymbolMatch> search(std::string_view query, size_t limit) const;
+      // number of live symbols
+      size_t size() const;
+  };
+}
+
+#endif // SFCC_SYMBOL_INDEX_HPP_
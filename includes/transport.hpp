@@ -0,0 +1,63 @@
+#ifndef SFCC_TRANSPORT_HPP_
+#define SFCC_TRANSPORT_HPP_
+
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+namespace lsp {
+  enum ReadResult {
+    READ_MESSAGE,
+    // the framing was fine but the body was not json, or the headers made no sense
+    READ_INVALID,
+    // the client closed its end
+    READ_CLOSED,
+  };
+
+  // base protocol framing over a pair of file descriptors. input goes through one buffer that is
+  // reused for every message. output is serialized once into another reused buffer and goes out with
+  // one writev, header and body together, without any stream in between.
+  class Transport {
+    private:
+      int in_fd;
+      int out_fd;
+
+      std::vector<char> buffer;
+      // unconsumed input is buffer[start, end)
+      size_t start = 0;
+      size_t end = 0;
+      std::string_view body;
+
+      std::mutex output_mutex;
+      // serialized messages, reused for every write under output_mutex
+      std::string output;
+
+      bool fill();
+      void write_frame(std::string_view body);
+      std::optional<size_t> parse_headers(std::string_view headers);
+
+    public:
+      Transport(int in_fd = STDIN_FILENO, int out_fd = STDOUT_FILENO);
+      Transport(const Transport&) = delete;
+      Transport& operator=(const Transport&) = delete;
+
+      // blocks until a whole message is there, it is parsed once straight out of the buffer
+      ReadResult read(json& message);
+      // raw body of the last message read, valid until the next read
+      std::string_view last_body() const { return this->body; }
+
+      // can be called from any thread. the message is serialized exactly once, `on_written` gets to see
+      // that serialization before the buffer is reused
+      void write(const json& message, const std::function<void(std::string_view)>& on_written = nullptr);
+      // a response around a result that is already serialized, only the envelope is written here
+      void write_response(const json& id, std::string_view result, const std::function<void(std::string_view)>& on_written = nullptr);
+  };
+}
+
+#endif // SFCC_TRANSPORT_HPP_
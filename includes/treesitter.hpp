@@ -4,8 +4,15 @@
 #include <tree_sitter/api.h>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <sstream>
+#include <document.hpp>
+#include <export_index.hpp>
+#include <parse_cache.hpp>
+#include <require_graph.hpp>
+#include <symbol_index.hpp>
+#include <queries.hpp>
 
 extern "C" const TSLanguage* tree_sitter_javascript(void);
 
@@ -14,27 +21,65 @@ namespace lsp {
     std::string cartridge_file_path;
   };
 
+  // a whole file with the parser of the calling thread, the caller owns the tree
+  TSTree* parse_source(std::string_view source);
+
   class TreeSitter {
     private:
       TSParser* ts_parser;
       const TSLanguage* lang;
-      void parse_object_toks(TSNode n, std::vector<std::string>& container, std::string& line);
-      std::string get_node_str_from_points(TSNode n, std::string& line);
+      struct {
+        uint32_t cartridge_fpath;
+        uint32_t declarator;
+        uint32_t name;
+        uint32_t export_left;
+        uint32_t export_right;
+        uint32_t require_function;
+        uint32_t require_path;
+        uint32_t require_call;
+        uint32_t member_expression;
+      } captures;
+      void parse_object_toks(TSNode n, std::vector<std::string>& container, std::string_view line);
+      std::string get_node_str_from_points(TSNode n, std::string_view line);
+      template <typename Text>
+      std::shared_ptr<const SymbolTable> collect_symbols(const TSTree* tree, Text text);
 
     public:
       TreeSitter() {
         this->ts_parser = ts_parser_new();
         this->lang = tree_sitter_javascript();
         ts_parser_set_language(this->ts_parser, this->lang);
+
+        QueryRegistry& registry = QueryRegistry::instance();
+        this->captures.cartridge_fpath = registry.get(QUERY_REQUIRE_LINE).capture_id("cartridge_fpath");
+        this->captures.declarator = registry.get(QUERY_VARIABLE_DECLARATION).capture_id("declarator");
+        this->captures.name = registry.get(QUERY_VARIABLE_DECLARATION).capture_id("name");
+        this->captures.export_left = registry.get(QUERY_EXPORT_ASSIGNMENT).capture_id("left");
+        this->captures.export_right = registry.get(QUERY_EXPORT_ASSIGNMENT).capture_id("right");
+        this->captures.require_function = registry.get(QUERY_REQUIRE_CALL).capture_id("function");
+        this->captures.require_path = registry.get(QUERY_REQUIRE_CALL).capture_id("path");
+        this->captures.require_call = registry.get(QUERY_REQUIRE_CALL).capture_id("call");
+        this->captures.member_expression = registry.get(QUERY_MEMBER_EXPRESSION).capture_id("member_expr");
       }
 
       ~TreeSitter() {
         ts_parser_delete(this->ts_parser);
       }
 
-      std::optional<RequireLineInfo> parse_require_line(std::string require_line);
-      std::optional<std::vector<std::string>> parse_object_expansion(std::string line);
-      std::optional<std::string> get_variable_decl(std::string file_content, std::string var_name);
+      // documents are only ever parsed on the main thread, everything below can be called from any thread
+      void parse(Document& document);
+
+      std::optional<RequireLineInfo> parse_require_line(std::string_view require_line);
+      std::optional<std::vector<std::string>> parse_object_expansion(std::string_view line);
+      // every declared name of the document, one walk over its tree
+      std::shared_ptr<const SymbolTable> build_symbols(const Document& document);
+      std::shared_ptr<const SymbolTable> build_symbols(const ParsedFile& file);
+      // what a module file assigns to `module.exports` and `exports`
+      ModuleExports exports_of(const TSTree* tree, const std::string& source);
+      // functions at any depth and the variables at the top of the file, requires left out
+      std::vector<Declaration> declarations_of(const TSTree* tree, const std::string& source);
+      // every `require('...')` of a file, also the ones not assigned to a variable, with the members used through it
+      std::vector<RequireSite> requires_of(const TSTree* tree, const std::string& source);
   };
 }
 
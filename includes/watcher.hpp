@@ -0,0 +1,76 @@
+#ifndef SFCC_WATCHER_HPP_
+#define SFCC_WATCHER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <file_cache.hpp>
+
+namespace lsp {
+  // values match the LSP FileChangeType
+  enum FileEventType {
+    FILE_CREATED = 1,
+    FILE_CHANGED = 2,
+    FILE_DELETED = 3,
+    // events were lost, everything has to be looked at again
+    FILE_RESCAN = 4,
+  };
+
+  struct FileEvent {
+    std::string path;
+    FileEventType type;
+    bool is_directory;
+  };
+
+  // watches every indexed directory through inotify and hands the changes over in batches.
+  // events are coalesced per path and only flushed once things have been quiet for a moment,
+  // so something like a branch switch ends up as a single batch instead of thousands of updates.
+  class Watcher {
+    private:
+      int inotify_fd = -1;
+      // written to on shutdown to wake the thread up from poll
+      int wake_fd = -1;
+      std::atomic<bool> watch_limit_reached = false;
+      std::atomic<bool> stopping = false;
+      std::thread thread;
+      std::function<void(std::vector<FileEvent>)> on_batch;
+      std::function<void()> on_limit;
+
+      std::mutex watches_mutex;
+      std::map<int, std::string> watches;
+
+      std::mutex pending_mutex;
+      std::map<std::string, FileEvent> pending;
+      std::chrono::steady_clock::time_point first_pending;
+      std::chrono::steady_clock::time_point last_pending;
+
+      void run();
+      void read_events();
+      void add_watch(const std::string& path);
+      void remove_watches(const std::string& path);
+      void add_directory(const std::string& path);
+      void queue(FileEvent event);
+      bool flush_due();
+      void flush();
+
+    public:
+      // `on_limit` is called once when inotify runs out of watches, from whichever thread added the watch
+      Watcher(std::function<void(std::vector<FileEvent>)> on_batch, std::function<void()> on_limit) : on_batch(on_batch), on_limit(on_limit) {};
+      Watcher(const Watcher&) = delete;
+      Watcher& operator=(const Watcher&) = delete;
+      ~Watcher();
+
+      // returns false when inotify is not available, external events are still batched
+      bool start();
+      void watch(const std::vector<DirectoryStamp>& directories);
+      // events reported by the client through workspace/didChangeWatchedFiles
+      void add_events(std::vector<FileEvent> events);
+  };
+}
+
+#endif // SFCC_WATCHER_HPP_
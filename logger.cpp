@@ -0,0 +1,229 @@
+#include "logger.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <unistd.h>
+
+using namespace lsp;
+
+static const size_t QUEUE_SIZE = 4096;
+static const size_t DEFAULT_MAX_MESSAGE_SIZE = 4096;
+static const size_t DEFAULT_MAX_FILE_SIZE = 10 * 1024 * 1024;
+// lsp.log.1 is the most recent of the rotated files
+static const int ROTATED_FILES = 2;
+
+std::optional<LogLevel> lsp::parse_log_level(std::string_view name) {
+  if (name == "off") return LOG_OFF;
+  if (name == "error") return LOG_ERROR;
+  if (name == "info") return LOG_INFO;
+  if (name == "debug") return LOG_DEBUG;
+  if (name == "trace") return LOG_TRACE;
+  return {};
+}
+
+static const char* level_name(LogLevel level) {
+  switch (level) {
+    case LOG_ERROR: return "ERROR";
+    case LOG_INFO: return "INFO";
+    case LOG_DEBUG: return "DEBUG";
+    case LOG_TRACE: return "TRACE";
+    default: return "";
+  }
+}
+
+Logger::Logger() :
+  slots(new Slot[QUEUE_SIZE]),
+  mask(QUEUE_SIZE - 1),
+  level(LOG_INFO),
+  max_message_size(DEFAULT_MAX_MESSAGE_SIZE),
+  max_file_size(DEFAULT_MAX_FILE_SIZE)
+{
+  for (size_t i = 0; i < QUEUE_SIZE; ++i) {
+    this->slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  const char* configured = std::getenv("SFCC_LSP_LOG_LEVEL");
+  if (configured != NULL) {
+    this->configure(parse_log_level(configured), {}, {});
+  }
+}
+
+Logger::~Logger() {
+  this->stopping = true;
+  this->wakeups.fetch_add(1, std::memory_order_release);
+  this->wakeups.notify_one();
+  if (this->thread.joinable()) {
+    this->thread.join();
+  }
+
+  if (this->fd >= 0) {
+    close(this->fd);
+  }
+}
+
+void Logger::start(const std::string& path) {
+  this->path = path;
+  this->thread = std::thread(&Logger::run, this);
+}
+
+void Logger::configure(std::optional<LogLevel> level, std::optional<size_t> max_message_size, std::optional<size_t> max_file_size) {
+  if (level.has_value()) {
+    this->level.store(level.value(), std::memory_order_relaxed);
+  }
+  if (max_message_size.has_value()) {
+    this->max_message_size.store(max_message_size.value(), std::memory_order_relaxed);
+  }
+  if (max_file_size.has_value()) {
+    this->max_file_size.store(max_file_size.value(), std::memory_order_relaxed);
+  }
+}
+
+void Logger::log(LogLevel level, std::string_view message) {
+  this->log(level, "", message);
+}
+
+void Logger::log(LogLevel level, std::string_view prefix, std::string_view message) {
+  if (!this->enabled(level)) {
+    return;
+  }
+
+  // only the part that is kept gets copied, whole documents stay where they are
+  size_t max_message_size = this->max_message_size.load(std::memory_order_relaxed);
+  Record record = { .level = level, .time = std::chrono::system_clock::now(), .message = {} };
+  if (max_message_size > 0 && message.size() > max_message_size) {
+    record.message.reserve(prefix.size() + max_message_size + 32);
+    record.message.append(prefix);
+    record.message.append(message.substr(0, max_message_size));
+    record.message.append("... (" + std::to_string(message.size() - max_message_size) + " more bytes)");
+  } else {
+    record.message.reserve(prefix.size() + message.size());
+    record.message.append(prefix);
+    record.message.append(message);
+  }
+
+  if (!this->push(std::move(record))) {
+    this->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  this->wakeups.fetch_add(1, std::memory_order_release);
+  this->wakeups.notify_one();
+}
+
+bool Logger::push(Record&& record) {
+  size_t position = this->enqueue_position.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true) {
+    slot = &this->slots[position & this->mask];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)sequence - (intptr_t)position;
+    if (diff == 0) {
+      if (this->enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // the writer is a whole queue behind
+      return false;
+    } else {
+      position = this->enqueue_position.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->record = std::move(record);
+  slot->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+// only ever called from the writer thread
+bool Logger::pop(Record& record) {
+  Slot& slot = this->slots[this->dequeue_position & this->mask];
+  if (slot.sequence.load(std::memory_order_acquire) != this->dequeue_position + 1) {
+    return false;
+  }
+
+  record = std::move(slot.record);
+  slot.sequence.store(this->dequeue_position + QUEUE_SIZE, std::memory_order_release);
+  this->dequeue_position++;
+  return true;
+}
+
+void Logger::run() {
+  std::string batch;
+  Record record;
+  while (true) {
+    // read before draining, a line pushed in between makes the wait below return right away
+    uint32_t seen = this->wakeups.load(std::memory_order_acquire);
+
+    batch.clear();
+    while (this->pop(record)) {
+      char time[32];
+      std::time_t seconds = std::chrono::system_clock::to_time_t(record.time);
+      struct tm local;
+      localtime_r(&seconds, &local);
+      strftime(time, sizeof(time), "%Y-%m-%d %H:%M:%S", &local);
+
+      batch.append(time);
+      batch.append(" ");
+      batch.append(level_name(record.level));
+      batch.append(" ");
+      batch.append(record.message);
+      batch.append("\n");
+    }
+
+    size_t dropped = this->dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+      batch.append("Dropped " + std::to_string(dropped) + " log lines\n");
+    }
+
+    if (!batch.empty()) {
+      this->write_out(batch);
+    }
+
+    if (this->stopping) {
+      return;
+    }
+    this->wakeups.wait(seen, std::memory_order_acquire);
+  }
+}
+
+void Logger::write_out(const std::string& batch) {
+  if (this->fd < 0) {
+    this->fd = open(this->path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    this->file_size = 0;
+    if (this->fd < 0) {
+      return;
+    }
+  }
+
+  size_t written = 0;
+  while (written < batch.size()) {
+    ssize_t len = write(this->fd, batch.data() + written, batch.size() - written);
+    if (len < 0 && errno == EINTR) {
+      continue;
+    }
+    if (len <= 0) {
+      return;
+    }
+    written += len;
+  }
+
+  this->file_size += written;
+  size_t max_file_size = this->max_file_size.load(std::memory_order_relaxed);
+  if (max_file_size > 0 && this->file_size >= max_file_size) {
+    this->rotate();
+  }
+}
+
+void Logger::rotate() {
+  close(this->fd);
+  this->fd = -1;
+
+  std::error_code ec;
+  for (int i = ROTATED_FILES - 1; i > 0; --i) {
+    std::filesystem::rename(this->path + "." + std::to_string(i), this->path + "." + std::to_string(i + 1), ec);
+  }
+  std::filesystem::rename(this->path, this->path + ".1", ec);
+}
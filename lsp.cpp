@@ -1,106 +1,615 @@
 #include "includes/lsp.hpp"
 #include "workspace.hpp"
+#include "crawler.hpp"
+#include "hash.hpp"
 #include <cstdlib>
+#include <set>
+#include <unordered_set>
 
 using namespace lsp;
 
-std::vector<std::string> split_string(const std::string& input, char delimiter) {
-    std::vector<std::string> tokens;
+// trees of closed modules kept around for definitions, can be changed with initializationOptions.parseCacheSize
+// how long a definition waits for the background indexing before answering with what is there
+static const std::chrono::seconds INDEX_WAIT(5);
+static const size_t DEFAULT_PARSE_CACHE_SIZE = 64 * 1024 * 1024;
+// larger module files are left out of the export index, they are bundles or generated
+static const std::streamoff MAX_MODULE_SOURCE_SIZE = 2 * 1024 * 1024;
+// below this many modules per thread the threads cost more than they save, file events mostly touch one
+static const size_t MODULES_PER_THREAD = 64;
+static const size_t WORKSPACE_SYMBOL_LIMIT = 100;
+// file events write the module index at most this often, see save_modules
+static const std::chrono::seconds MODULE_SAVE_INTERVAL(60);
+static const std::string INDEXING_PROGRESS_TOKEN = "sfcc-lsp/indexing";
+
+void LSP::prepare_data_dir() {
+  const char* home = std::getenv("HOME");
+  assert(home != NULL && "This has been ran on a non posix system");
+  std::filesystem::path data_dir = std::filesystem::path(home) / ".sfcclsp";
+  std::filesystem::create_directories(data_dir);
+  this->data_dir = data_dir;
+  this->logger.start((data_dir / "lsp.log").string());
+}
+
+// the queries are compiled up front, a broken one shows up in the log at launch instead of on the first request
+void LSP::compile_queries() {
+  for (const auto& error : QueryRegistry::instance().errors()) {
+    this->log(LOG_ERROR, error);
+  }
+}
+
+// initializationOptions win over SFCC_LSP_LOG_LEVEL
+void LSP::configure_logging(const json& options) {
+  if (!options.is_object()) {
+    return;
+  }
+
+  std::optional<LogLevel> level;
+  if (options.contains("logLevel") && options["logLevel"].is_string()) {
+    level = parse_log_level(options["logLevel"].template get<std::string>());
+  }
+  std::optional<size_t> max_message_size;
+  if (options.contains("logMaxMessageSize") && options["logMaxMessageSize"].is_number_unsigned()) {
+    max_message_size = options["logMaxMessageSize"].template get<size_t>();
+  }
+  std::optional<size_t> max_file_size;
+  if (options.contains("logMaxFileSize") && options["logMaxFileSize"].is_number_unsigned()) {
+    max_file_size = options["logMaxFileSize"].template get<size_t>();
+  }
+  this->logger.configure(level, max_message_size, max_file_size);
+}
+
+lsp::LSP::LSP(std::span<const CompletionEntry> completions, std::string current_path) :
+  completion(completions),
+  current_path(current_path),
+  parse_cache(DEFAULT_PARSE_CACHE_SIZE),
+  dispatcher(Dispatcher::default_thread_count()),
+  watcher([this](std::vector<FileEvent> events) { this->apply_file_events(std::move(events)); },
+      [this]() { this->register_watched_files(false); })
+{
+  prepare_data_dir();
+  compile_queries();
+};
+
+lsp::LSP::LSP(std::span<const CompletionEntry> completions, std::string current_path, std::map<std::string, std::string> documents) : 
+  completion(completions),
+  current_path(current_path),
+  parse_cache(DEFAULT_PARSE_CACHE_SIZE),
+  dispatcher(Dispatcher::default_thread_count()),
+  watcher([this](std::vector<FileEvent> events) { this->apply_file_events(std::move(events)); },
+      [this]() { this->register_watched_files(false); })
+{
+  for (auto& [uri, text] : documents) {
+    auto [it, inserted] = this->documents.insert({uri, Document(text, 0)});
+    this->ts.parse(it->second);
+  }
+  prepare_data_dir();
+  compile_queries();
+};
+
+void LSP::send(const json& message) {
+  this->transport.write(message);
+}
+
+void LSP::respond(const json& response) {
+  if (!this->log_enabled(LOG_TRACE)) {
+    this->transport.write(response);
+    return;
+  }
+
+  this->transport.write(response, [this](std::string_view body) {
+      this->log(LOG_TRACE, "[RESPONSE]: ", body);
+      });
+}
+
+void LSP::respond_result(const json& id, std::string_view result) {
+  if (!this->log_enabled(LOG_TRACE)) {
+    this->transport.write_response(id, result);
+    return;
+  }
+
+  this->transport.write_response(id, result, [this](std::string_view body) {
+      this->log(LOG_TRACE, "[RESPONSE]: ", body);
+      });
+}
+
+void LSP::log(LogLevel level, std::string_view message) {
+  this->logger.log(level, message);
+}
+
+void LSP::log(LogLevel level, std::string_view prefix, std::string_view message) {
+  this->logger.log(level, prefix, message);
+}
+
+void LSP::begin_progress(std::string message) {
+  std::lock_guard<std::mutex> lock(this->progress_mutex);
+  this->progress_running = true;
+  this->progress_message = message;
+  if (!this->progress_token.has_value()) {
+    return;
+  }
+
+  this->progress_begun = true;
+  this->send(NotificationMessage<ProgressParams<WorkDoneProgressBegin>>{
+      .method = "$/progress",
+      .params = { .token = this->progress_token.value(), .value = { .title = "Indexing cartridges", .message = message } },
+      });
+}
+
+void LSP::report_progress(std::string message) {
+  std::lock_guard<std::mutex> lock(this->progress_mutex);
+  this->progress_message = message;
+  if (!this->progress_begun) {
+    return;
+  }
+
+  this->send(NotificationMessage<ProgressParams<WorkDoneProgressReport>>{
+      .method = "$/progress",
+      .params = { .token = this->progress_token.value(), .value = { .kind = "report", .message = message } },
+      });
+}
+
+void LSP::end_progress(std::string message) {
+  std::lock_guard<std::mutex> lock(this->progress_mutex);
+  this->progress_running = false;
+  if (!this->progress_begun) {
+    return;
+  }
+
+  this->progress_begun = false;
+  this->send(NotificationMessage<ProgressParams<WorkDoneProgressReport>>{
+      .method = "$/progress",
+      .params = { .token = this->progress_token.value(), .value = { .kind = "end", .message = message } },
+      });
+}
+
+// the token can show up after indexing already started, in that case the progress is picked up where it is
+void LSP::activate_progress(json token) {
+  std::string message;
+  {
+    std::lock_guard<std::mutex> lock(this->progress_mutex);
+    this->progress_token = token;
+    if (!this->progress_running || this->progress_begun) {
+      return;
+    }
+    message = this->progress_message;
+  }
+  this->begin_progress(message);
+}
+
+static std::vector<std::string> parse_cartridge_path(const json& value) {
+  std::vector<std::string> cartridges;
+  if (value.is_array()) {
+    for (const auto& cartridge : value) {
+      if (cartridge.is_string()) {
+        cartridges.push_back(cartridge.template get<std::string>());
+      }
+    }
+  } else if (value.is_string()) {
+    std::string path = value.template get<std::string>();
     size_t start = 0, end = 0;
+    while (start < path.size()) {
+      end = path.find(':', start);
+      if (end == std::string::npos) {
+        end = path.size();
+      }
+      if (end > start) {
+        cartridges.push_back(path.substr(start, end - start));
+      }
+      start = end + 1;
+    }
+  }
+  return cartridges;
+}
 
-    while ((end = input.find(delimiter, start)) != std::string::npos) {
-        tokens.push_back(input.substr(start, end - start));
-        start = end + 1;
+void LSP::load_cartridge_path(const json& options) {
+  std::vector<std::string> cartridge_path;
+  if (options.is_object() && options.contains("cartridgePath")) {
+    cartridge_path = parse_cartridge_path(options["cartridgePath"]);
+  } else {
+    std::ifstream dw_json(std::filesystem::path(this->current_path) / "dw.json");
+    json dw = dw_json.is_open() ? json::parse(dw_json, nullptr, false) : json();
+    // its `cartridge` field is what gets uploaded, that says nothing about the order they are looked up in
+    if (dw.is_object() && dw.contains("cartridgePath")) {
+      cartridge_path = parse_cartridge_path(dw["cartridgePath"]);
     }
+  }
 
-    tokens.push_back(input.substr(start));
+  this->cartridge_ranks = lsp::cartridge_ranks(cartridge_path);
+  if (cartridge_path.empty()) {
+    this->log(LOG_INFO, "No cartridgePath configured, every override of a module is a definition");
+  } else {
+    this->log(LOG_INFO, "Resolving modules through a cartridge path of " + std::to_string(cartridge_path.size()) + " cartridges");
+  }
+}
 
-    return tokens;
+// without inotify, or once it ran out of watches, the client is asked to report the changes instead.
+// `initialized` is the client becoming ready, otherwise inotify fell short. registers once both happened
+void LSP::register_watched_files(bool initialized) {
+  {
+    std::lock_guard<std::mutex> lock(this->watched_files_mutex);
+    if (initialized) {
+      this->client_initialized = true;
+    } else {
+      this->watched_files_needed = true;
+    }
+    if (!this->client_initialized || !this->watched_files_needed || this->watched_files_registered || !this->client_supports_watched_files) {
+      return;
+    }
+    this->watched_files_registered = true;
+  }
+
+  this->log(LOG_INFO, "Asking the client to report file changes");
+  this->send(RequestMessage<RegistrationParams<DidChangeWatchedFilesRegistrationOptions>>{
+      .id = "sfcc-lsp/watched-files",
+      .method = "client/registerCapability",
+      .params = { .registrations = {
+        { .id = "sfcc-lsp/watched-files", .method = "workspace/didChangeWatchedFiles", .registerOptions = { .watchers = { { .globPattern = "**/cartridge/**" } } } },
+      } },
+      });
 }
 
-bool is_forbidden(std::string& path_str) {
-    return path_str.find(".git") != std::string::npos ||
-      path_str.find("node_modules") != std::string::npos ||
-      path_str.find("test") != std::string::npos;
+// the workDoneToken of initialize is not used, it ends with the initialize response and indexing outlives it
+void LSP::start_indexing(const json& params) {
+  auto capabilities = params.find("capabilities");
+  if (capabilities != params.end() && capabilities->contains("window")) {
+    this->client_supports_progress = (*capabilities)["window"].value("workDoneProgress", false);
+  }
+  if (capabilities != params.end() && capabilities->contains("workspace")) {
+    this->client_supports_watched_files = (*capabilities)["workspace"].value("/didChangeWatchedFiles/dynamicRegistration"_json_pointer, false);
+  }
+
+  size_t crawler_threads = Crawler::default_thread_count();
+  auto options = params.find("initializationOptions");
+  if (options != params.end() && options->is_object() && options->contains("crawlerThreads") && (*options)["crawlerThreads"].is_number_unsigned()) {
+    crawler_threads = (*options)["crawlerThreads"].template get<size_t>();
+  }
+  this->crawler_threads = std::clamp(crawler_threads, (size_t)1, MAX_CRAWLER_THREADS);
+  if (options != params.end() && options->is_object() && options->contains("parseCacheSize") && (*options)["parseCacheSize"].is_number_unsigned()) {
+    this->parse_cache.set_budget((*options)["parseCacheSize"].template get<size_t>());
+  }
+  this->configure_logging(options != params.end() ? *options : json());
+  this->load_cartridge_path(options != params.end() ? *options : json());
+
+  if (!this->watcher.start()) {
+    this->log(LOG_ERROR, "inotify is not available, relying on the client for file changes");
+    this->register_watched_files(false);
+  }
+  this->indexer = std::thread([this]() { this->build_file_cache(this->crawler_threads); });
 }
 
-void process_dir(std::filesystem::path path, lsp::FileCache& fc) {
-  auto path_str = path.string();
+void LSP::build_file_cache(size_t thread_count) {
+  this->begin_progress("Loading the file index");
+  std::filesystem::path index_path = file_index_path(this->data_dir, this->current_path);
 
-  if (is_forbidden(path_str)) return; 
+  auto stored = load_file_index(index_path, this->current_path);
+  FileIndex index;
+  if (stored.has_value()) {
+    index = std::move(stored.value());
+    this->log(LOG_INFO, "Loaded file index " + index_path.string() + " with " + std::to_string(index.fc.size()) + " entries");
+  } else {
+    Crawler crawler(thread_count);
+    index = crawler.crawl(this->current_path, [this](size_t visited) {
+        this->report_progress("Visited " + std::to_string(visited) + " directories");
+        });
 
-  for (const auto& entry : std::filesystem::directory_iterator(path)) {
-    if (entry.is_directory()) {
-      process_dir(entry.path(), fc);
-    } else {
-      auto file_path = entry.path().string();
+    if (!save_file_index(index_path, this->current_path, index)) {
+      this->log(LOG_ERROR, "Could not write the file index to " + index_path.string());
+    }
+  }
+
+  size_t files = index.fc.size();
+  index.fc.set_ranks(this->cartridge_ranks);
+  this->watcher.watch(index.directories);
+  {
+    std::unique_lock<std::shared_mutex> lock(this->index_mutex);
+    this->index = std::move(index);
+    this->refresh_cartridges();
+    this->index_ready = true;
+  }
+  this->index_cv.notify_all();
+  this->build_module_index();
+  this->end_progress("Indexed " + std::to_string(files) + " cartridge modules");
+}
+
+void LSP::save_index() {
+  std::filesystem::path index_path = file_index_path(this->data_dir, this->current_path);
+  std::shared_lock<std::shared_mutex> lock(this->index_mutex);
+  if (!save_file_index(index_path, this->current_path, this->index)) {
+    this->log(LOG_ERROR, "Could not write the file index to " + index_path.string());
+  }
+}
+
+static bool is_under(const std::string& path, const std::string& directory) {
+  return path.size() > directory.size() && path.starts_with(directory) && path[directory.size()] == '/';
+}
+
+// applies one coalesced batch of file system changes to the index. only names matter here, so
+// content changes are skipped. this runs on the watcher thread and holds the index lock for the
+// whole batch, readers see either none or all of it.
+void LSP::apply_file_events(std::vector<FileEvent> events) {
+  for (const auto& event : events) {
+    if (event.type == FILE_RESCAN) {
+      this->log(LOG_INFO, "File events were dropped, rebuilding the file index");
+      Crawler crawler(this->crawler_threads);
+      FileIndex index = crawler.crawl(this->current_path);
+      index.fc.set_ranks(this->cartridge_ranks);
+      this->watcher.watch(index.directories);
+      {
+        std::unique_lock<std::shared_mutex> lock(this->index_mutex);
+        this->index = std::move(index);
+        this->refresh_cartridges();
+        this->index_ready = true;
+      }
+      this->index_cv.notify_all();
+      this->save_index();
+      this->exports.clear();
+      this->require_graph.clear();
+      this->workspace_symbols.clear();
+      this->build_module_index();
+      return;
+    }
+  }
+
+  // modules are read and parsed once the index lock is released
+  std::vector<std::string> changed_modules;
+  bool modules_removed = false;
+
+  size_t applied = 0;
+  {
+    std::unique_lock<std::shared_mutex> lock(this->index_mutex);
+    FileCache& fc = this->index.fc;
+    std::map<std::string, size_t> stamps;
+    for (size_t i = 0; i < this->index.directories.size(); ++i) {
+      stamps[this->index.directories[i].path] = i;
+    }
 
-      // @TODO: this `/` delim is not cross platform
-      std::vector<std::string> toks = split_string(file_path, '/');
+    std::vector<std::string> removed_directories;
+    std::set<std::string> touched_directories;
+    workspace::cartridges cartridges_before = this->index.cartridges;
+
+    for (const auto& event : events) {
+      if (is_forbidden_path(event.path)) {
+        continue;
+      }
+      if (event.type != FILE_DELETED && !event.is_directory && is_module_path(event.path)) {
+        changed_modules.push_back(event.path);
+        this->parse_cache.invalidate(event.path);
+      }
+      if (event.type == FILE_CHANGED) {
+        continue;
+      }
+      applied++;
+      std::filesystem::path path(event.path);
+      touched_directories.insert(path.parent_path().string());
 
-      size_t cartridge_pos = 0;
-      for (size_t i = 0; i < toks.size(); ++i) {
-        if (toks.at(i) == "cartridge") {
-          cartridge_pos = i;
+      if (event.type == FILE_CREATED && event.is_directory) {
+        touched_directories.insert(event.path);
+        if (path.filename() == "cartridge") {
+          this->index.cartridges.insert_or_assign(path.parent_path().filename().string(), path.parent_path().string());
         }
+        continue;
       }
 
-      if (cartridge_pos == 0) {
+      auto key = cartridge_key(event.path);
+      if (event.type == FILE_CREATED) {
+        fc.add(event.path);
         continue;
       }
 
-      std::string cartridge_file = std::accumulate(
-          toks.begin() + cartridge_pos,
-          toks.end(),
-          std::string(),
-          [](std::string a, std::string b) {
-            return a + "/" + b;
+      // deletions reported by the client do not say whether it was a directory
+      this->exports.remove(event.path);
+      this->require_graph.remove(event.path);
+      this->workspace_symbols.remove(event.path);
+      modules_removed = true;
+      this->parse_cache.invalidate(event.path);
+      if (!key.has_value() || !fc.remove(event.path)) {
+        removed_directories.push_back(event.path);
+      }
+    }
+
+    // one sweep over the cache for all of the removed directories
+    if (!removed_directories.empty()) {
+      auto removed = [&removed_directories](const std::string& path) {
+        for (const auto& directory : removed_directories) {
+          if (path == directory || is_under(path, directory)) {
+            return true;
+          }
+        }
+        return false;
+      };
+
+      fc.remove_under(removed_directories);
+      this->exports.remove_under(removed_directories);
+      this->require_graph.remove_under(removed_directories);
+      this->workspace_symbols.remove_under(removed_directories);
+      std::erase_if(this->index.cartridges, [&removed](const auto& cartridge) {
+          return removed(cartridge.second) || removed(cartridge.second + "/cartridge");
           });
+      std::erase_if(this->index.directories, [&removed](const DirectoryStamp& stamp) { return removed(stamp.path); });
 
-      if (fc.find(cartridge_file) == fc.end()) {
-        fc.insert({cartridge_file, std::vector<std::string> { file_path }});
+      stamps.clear();
+      for (size_t i = 0; i < this->index.directories.size(); ++i) {
+        stamps[this->index.directories[i].path] = i;
+      }
+    }
+
+    if (this->index.cartridges != cartridges_before) {
+      this->refresh_cartridges();
+    }
+
+    for (const auto& directory : touched_directories) {
+      auto mtime = directory_mtime(directory);
+      if (!mtime.has_value()) {
         continue;
       }
 
-      fc[cartridge_file].push_back(file_path);
+      auto stamp = stamps.find(directory);
+      if (stamp != stamps.end()) {
+        this->index.directories[stamp->second].mtime = mtime.value();
+      } else if (directory == this->current_path || is_under(directory, this->current_path)) {
+        this->index.directories.push_back((DirectoryStamp) { .path = directory, .mtime = mtime.value() });
+      }
     }
   }
+
+  if (applied > 0) {
+    this->log(LOG_INFO, "Applied " + std::to_string(applied) + " file changes to the index");
+    this->save_index();
+  }
+  this->index_modules(changed_modules, true);
+  if (!changed_modules.empty() || modules_removed) {
+    this->modules_dirty = true;
+    this->save_modules(false);
+  }
 }
 
-void LSP::prepare_log_file() {
-  const char* home = std::getenv("HOME");
-  assert(home != NULL && "This has been ran on a non posix system");
-  std::filesystem::path log_dir = std::filesystem::path(home) / ".sfcclsp";
-  std::filesystem::path log_path = log_dir / "lsp.log";
-  std::filesystem::create_directories(log_dir);
-  this->log_file = std::ofstream(log_path);
-  this->build_file_cache();
+bool LSP::is_module_path(const std::string& path) {
+  return path.ends_with(".js") && cartridge_key(path).has_value();
 }
 
-lsp::LSP::LSP(std::vector<CompletionItem> items, std::string current_path) :
-  items(items),
-  current_path(current_path) 
-{
-  prepare_log_file();
-};
+// one parse for both the exports and the requires, the tree is thrown away right after
+void LSP::index_module(const std::string& path, bool replace) {
+  auto stamp = file_stamp(path);
+  if (!stamp.has_value() || stamp->size > (uint64_t)MAX_MODULE_SOURCE_SIZE) {
+    return;
+  }
 
-lsp::LSP::LSP(std::vector<CompletionItem> items, std::string current_path, std::map<std::string, std::string> documents) : 
-  items(items),
-  current_path(current_path),
-  documents(documents) 
-{
-  prepare_log_file();
-};
+  // the same tree definitions use, a file is parsed once per version whoever needs it first
+  auto parsed = this->parse_cache.get(path);
+  if (parsed == nullptr) {
+    return;
+  }
+  // the stamp of what was actually parsed, a file changing in between is parsed again on the next start
+  stamp = (FileStamp) { .mtime = parsed->mtime, .size = parsed->source.size() };
+  const TSTree* tree = parsed->tree;
+  const std::string& source = parsed->source;
 
-void LSP::build_file_cache(void) {
-  process_dir(std::filesystem::path(this->current_path), this->fc);
+  ModuleExports module_exports = this->ts.exports_of(tree, source);
+  std::vector<Declaration> declarations = this->ts.declarations_of(tree, source);
+  this->require_graph.set(path, stamp.value(), this->ts.requires_of(tree, source), replace);
+
+  // `calc: calc` would list calc twice, the export only shows up when nothing in the file has its name
+  std::unordered_set<std::string> declared;
+  for (const auto& declaration : declarations) {
+    declared.insert(declaration.name);
+  }
+  for (const auto& [name, exported] : module_exports) {
+    if (!declared.contains(name)) {
+      declarations.push_back((Declaration) { .name = name, .kind = SYMBOL_KIND_PROPERTY, .line = exported.line, .start = exported.start, .end = exported.end });
+    }
+  }
+  this->exports.set(path, std::move(module_exports), replace);
+  this->workspace_symbols.set(path, std::move(declarations), replace);
 }
 
-std::optional<std::string> LSP::get_document(std::string uri) {
-  if (this->documents.contains(uri)) {
-    return this->documents[uri];
+// the workers take the next path off of a shared counter, each of them parses with its own thread local parser
+void LSP::index_modules(const std::vector<std::string>& paths, bool replace) {
+  std::atomic<size_t> next = 0;
+  std::atomic<size_t> done = 0;
+  auto work = [this, &paths, &next, &done, replace]() {
+    for (size_t i = next++; i < paths.size() && !this->stopping.load(); i = next++) {
+      this->index_module(paths[i], replace);
+      size_t indexed = ++done;
+      if (indexed % 1000 == 0) {
+        this->report_progress("Indexed " + std::to_string(indexed) + " of " + std::to_string(paths.size()) + " modules");
+      }
+    }
+  };
+
+  size_t thread_count = std::min(this->crawler_threads, paths.size() / MODULES_PER_THREAD + 1);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
   }
-  return {};
+}
+
+// runs after the file cache is ready, definitions fall back to the top of the module until it is done.
+// modules that did not change since the last run come from the stored index and are not parsed again
+void LSP::build_module_index() {
+  std::vector<std::string> paths;
+  {
+    std::shared_lock<std::shared_mutex> lock(this->index_mutex);
+    paths = this->index.fc.paths();
+  }
+  std::erase_if(paths, [](const std::string& path) { return !is_module_path(path); });
+
+  auto start = std::chrono::steady_clock::now();
+  size_t restored = 0;
+  std::filesystem::path index_path = module_index_path(this->data_dir, this->current_path);
+  auto stored = load_module_index(index_path, this->current_path);
+  if (stored.has_value()) {
+    std::unordered_set<std::string> live(paths.begin(), paths.end());
+    for (auto& record : stored.value()) {
+      if (!live.contains(record.path) || file_stamp(record.path) != record.stamp) {
+        continue;
+      }
+      this->exports.set(record.path, std::move(record.exports), false);
+      this->require_graph.set(record.path, record.stamp, std::move(record.sites), false);
+      this->workspace_symbols.set(record.path, std::move(record.declarations), false);
+      live.erase(record.path);
+      restored++;
+    }
+    std::erase_if(paths, [&live](const std::string& path) { return !live.contains(path); });
+  }
+
+  this->index_modules(paths, false);
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  this->log(LOG_INFO, "Indexed the exports and requires of " + std::to_string(this->require_graph.size()) + " modules and " + std::to_string(this->workspace_symbols.size()) + " symbols in " + std::to_string(elapsed.count()) + "ms, " + std::to_string(restored) + " unchanged ones from " + index_path.string());
+  if (!stored.has_value() || !paths.empty() || restored != stored->size()) {
+    this->modules_dirty = true;
+    // the destructor writes it, it does not need to hold up the shutdown here
+    if (!this->stopping.load()) {
+      this->save_modules(true);
+    }
+  }
+}
+
+// the indexer, the watcher and the shutdown can all get here, one of them writes at a time. the stored
+// index only speeds up the next start, files changed since the last write are simply parsed again then
+void LSP::save_modules(bool force) {
+  std::lock_guard<std::mutex> lock(this->modules_save_mutex);
+  auto now = std::chrono::steady_clock::now();
+  if (!this->modules_dirty.load() || (!force && now - this->modules_saved < MODULE_SAVE_INTERVAL)) {
+    return;
+  }
+  this->modules_dirty = false;
+  this->modules_saved = now;
+
+  std::vector<ModuleRecord> records;
+  this->require_graph.for_each([this, &records](const std::string& path, const FileStamp& stamp, const std::vector<Dependency>& dependencies) {
+      ModuleRecord record = { .path = path, .stamp = stamp, .exports = this->exports.get(path).value_or(ModuleExports {}), .sites = {}, .declarations = this->workspace_symbols.get(path) };
+      for (const auto& dependency : dependencies) {
+        record.sites.push_back(dependency.site);
+      }
+      records.push_back(std::move(record));
+      });
+
+  std::filesystem::path index_path = module_index_path(this->data_dir, this->current_path);
+  if (!save_module_index(index_path, this->current_path, records)) {
+    this->log(LOG_ERROR, "Could not write the module index to " + index_path.string());
+  }
+}
+
+// the index is swapped in whole, until then it is empty. `wait` holds the request back a bounded time
+// for it, an empty answer would look like there is nothing to find and the client would not ask again
+std::shared_lock<std::shared_mutex> LSP::lock_index(bool wait) {
+  std::shared_lock<std::shared_mutex> lock(this->index_mutex);
+  if (wait) {
+    this->index_cv.wait_for(lock, INDEX_WAIT, [this]() { return this->index_ready; });
+  }
+  return lock;
+}
+
+Document* LSP::get_document(const std::string& uri) {
+  auto it = this->documents.find(uri);
+  if (it == this->documents.end()) {
+    return nullptr;
+  }
+  return &it->second;
 }
 
 std::string LSP::to_uri(std::string file_path) {
@@ -109,142 +618,813 @@ std::string LSP::to_uri(std::string file_path) {
   return file_uri;
 }
 
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+// percent escapes are decoded, a `%` not followed by two hex digits is kept as it is
+std::string LSP::from_uri(std::string uri) {
+  std::string path;
+  size_t start = uri.starts_with("file://") ? 7 : 0;
+  for (size_t i = start; i < uri.size(); ++i) {
+    int high = uri[i] == '%' && i + 2 < uri.size() ? hex_digit(uri[i + 1]) : -1;
+    int low = high < 0 ? -1 : hex_digit(uri[i + 2]);
+    if (low >= 0) {
+      path.push_back((char)(high * 16 + low));
+      i += 2;
+    } else {
+      path.push_back(uri[i]);
+    }
+  }
+  return path;
+}
+
+
+std::string LSP::handle_completion(std::string_view word) {
+  return this->completion.complete(word);
+}
+
+static const std::string_view REQUIRE_ROOT = "*/cartridge/";
+static const size_t REQUIRE_COMPLETION_LIMIT = 50;
+
+static std::string sort_text(size_t rank) {
+  char text[16];
+  snprintf(text, sizeof(text), "%05zu", rank);
+  return text;
+}
+
+CompletionList LSP::handle_require_completion(std::string_view typed, Position cursor) {
+  CompletionList list = { .isIncomplete = false, .items = {} };
+  auto replacing = [&cursor](std::string_view text) {
+    return (Range) {
+      .start = (Position) { .line = cursor.line, .character = cursor.character - (int)utf16_length(text) },
+      .end = cursor,
+    };
+  };
+
+  // nothing to look up before the root is typed out, but it can be completed
+  if (!typed.starts_with(REQUIRE_ROOT)) {
+    if (REQUIRE_ROOT.starts_with(typed)) {
+      list.items.push_back((CompletionItem) {
+          .label = std::string(REQUIRE_ROOT),
+          .kind = COMPLETION_KIND_FOLDER,
+          .detail = "cartridge path",
+          .sortText = sort_text(0),
+          .textEdit = { .range = replacing(typed), .newText = std::string(REQUIRE_ROOT) },
+          });
+    }
+    return list;
+  }
+
+  // only the segment being typed is replaced, everything before the last slash picks the trie node
+  std::string_view path = typed.substr(REQUIRE_ROOT.size());
+  size_t slash = path.rfind('/');
+  std::string_view directory = slash == std::string_view::npos ? "" : path.substr(0, slash);
+  std::string_view partial = slash == std::string_view::npos ? path : path.substr(slash + 1);
+
+  ModuleCompletions completions;
+  {
+    auto lock = this->lock_index(false);
+    completions = this->index.fc.modules().complete(directory, partial, REQUIRE_COMPLETION_LIMIT);
+    // the client asks again on the next keystroke instead of filtering an empty list
+    completions.incomplete = completions.incomplete || !this->index_ready;
+  }
+
+  list.isIncomplete = completions.incomplete;
+  for (const auto& completion : completions.items) {
+    std::string text = completion.directory ? completion.name + "/" : completion.name;
+    std::string detail = "module";
+    if (completion.directory) {
+      detail = std::to_string(completion.modules) + (completion.modules == 1 ? " module" : " modules");
+    }
 
-CompletionList LSP::handle_completion(json request) {
-  return CompletionList(false, this->items);
+    list.items.push_back((CompletionItem) {
+        .label = text,
+        .kind = completion.directory ? COMPLETION_KIND_FOLDER : COMPLETION_KIND_MODULE,
+        .detail = std::move(detail),
+        .sortText = sort_text(list.items.size()),
+        .textEdit = { .range = replacing(partial), .newText = text },
+        });
+  }
+  return list;
 }
 
 
-std::optional<std::vector<Location>> LSP::goto_definition_require_line(std::string line) {
+std::optional<std::vector<Location>> LSP::goto_definition_require_line(std::string_view line, bool all_overrides) {
   auto req = this->ts.parse_require_line(line);
 
   if (!req.has_value())  {
     return {};
   }
 
+  return this->goto_required_module(req.value().cartridge_file_path, all_overrides, "");
+}
+
+std::optional<std::vector<Location>> LSP::goto_required_module(std::string require, bool all_overrides, std::string_view member) {
+  if (require.empty()) {
+    return {};
+  }
+
   // */cartridge/something/something
-  std::string require = req.value().cartridge_file_path;
   require.append(".js"); // */cartridge/something/something.js
   require.replace(0, 1, ""); // /cartridge/something/something.js
 
-  if (this->fc.find(require) == this->fc.end()) {
+  std::vector<std::string> chain;
+  {
+    auto lock = this->lock_index(true);
+    chain = this->index.fc.lookup(require);
+  }
+  if (chain.empty()) {
     return {};
   }
 
+  // the chain is ordered by the cartridge path, so its head is the file the platform would load
+  if (!all_overrides && this->cartridge_ranks.contains(cartridge_name(chain.front()))) {
+    chain.resize(1);
+  }
+
+  // without the index lock, a module that is not indexed yet gets read and parsed in member_range
   std::vector<Location> locations;
-  for (const auto& path : this->fc[require]) {
-    locations.push_back(
-      (Location) {
-        .uri = this->to_uri(path),
-        .range = (Range) {
-          .start = (Position) {.line = 0, .character = 0},
-          .end   = (Position) {.line = 0, .character = 0},
-        }
-      });
+  for (const auto& path : chain) {
+    locations.push_back((Location) { .uri = this->to_uri(path), .range = this->member_range(path, member) });
   }
 
   return locations;
 }
 
-std::optional<std::vector<Location>> LSP::handle_definition(json request) {
-  std::string textDocumentUri = request["params"]["textDocument"]["uri"];
-  Position position = request["params"]["position"].template get<Position>();
-
-  auto document = this->get_document(textDocumentUri);
-  if (!document.has_value()) {
-    return {};
+// where `member` of a module is defined. an export assigned from a variable or function lands on that
+// declaration, any other export on its name and anything unknown on the top of the file
+Range LSP::member_range(const std::string& path, std::string_view member) {
+  Range range = { .start = { .line = 0, .character = 0 }, .end = { .line = 0, .character = 0 } };
+  if (member.empty()) {
+    return range;
   }
 
-  std::vector<std::string> lines;
-  std::string buff;
-  std::stringstream ss(document.value());
-  while (std::getline(ss, buff, '\n')) {
-    lines.push_back(buff);
+  auto target = this->exports.find(path, member);
+  if (!target.has_value() && !this->exports.contains(path)) {
+    // not indexed yet, the tree stays cached for the next time
+    auto parsed = this->parse_cache.get(path);
+    if (parsed == nullptr) {
+      return range;
+    }
+    ModuleExports module_exports = this->ts.exports_of(parsed->tree, parsed->source);
+    auto it = module_exports.find(std::string(member));
+    if (it != module_exports.end()) {
+      target = it->second;
+    }
+    this->exports.set(path, std::move(module_exports), false);
+  }
+  if (!target.has_value()) {
+    return range;
   }
 
-  auto require_line = this->goto_definition_require_line(lines[position.line]);
+  return (Range) {
+    .start = { .line = (int)target->target_line, .character = (int)target->target_start },
+    .end = { .line = (int)target->target_line, .character = (int)target->target_end },
+  };
+}
+
+std::optional<std::vector<Location>> LSP::handle_definition(const Document& document, Position position, bool all_overrides) {
+  std::string scratch;
+  std::string_view line = document.line_view(position.line, scratch);
+  auto require_line = this->goto_definition_require_line(line, all_overrides);
   if (require_line.has_value()) {
     return require_line.value();
   }
 
-  auto object_tokens = this->ts.parse_object_expansion(lines[position.line]);
-  if (object_tokens.has_value() && object_tokens.value().size() > 0) {
-    auto module = object_tokens.value().at(0);
-    auto variable_decl_line = this->ts.get_variable_decl(document.value(), module);
-    if (!variable_decl_line.has_value()) {
+  auto object_tokens = this->ts.parse_object_expansion(line);
+  const auto& symbols = document.get_symbols();
+  if (object_tokens.has_value() && object_tokens.value().size() > 0 && symbols != nullptr) {
+    auto symbol = symbols->find(object_tokens.value().at(0));
+    if (symbol == symbols->end()) {
       return {};
     }
 
-    this->log_file << "The line for the definition is '" << variable_decl_line.value() << std::endl;
+    this->log(LOG_DEBUG, "'" + symbol->first + "' is declared as a require of '" + symbol->second.require + "'");
+    std::string_view member = object_tokens.value().size() > 1 ? std::string_view(object_tokens.value().at(1)) : "";
+    return this->goto_required_module(symbol->second.require, all_overrides, member);
+  }
 
-    auto require_line = this->goto_definition_require_line(variable_decl_line.value());
-    if (require_line.has_value()) {
-      return require_line.value(); 
-    }
+  return {};
+}
+
+// has to be called with the index locked exclusively
+void LSP::refresh_cartridges() {
+  uint64_t hash = fnv1a("");
+  this->cartridge_entries.clear();
+  for (const auto& cartridge : this->index.cartridges) {
+    this->cartridge_entries.push_back((CartridgeEntry) {
+        .file_path = cartridge.second,
+        .file_name = cartridge.first,
+        });
+    hash = fnv1a(cartridge.first, hash);
+    hash = fnv1a(std::string_view("\0", 1), hash);
+    hash = fnv1a(cartridge.second, hash);
+    hash = fnv1a(std::string_view("\0", 1), hash);
+  }
+
+  char etag[17];
+  snprintf(etag, sizeof(etag), "%016llx", (unsigned long long)hash);
+  this->cartridges_etag = etag;
+}
+
+std::optional<json> LSP::handle_cartridges(const std::optional<std::string>& etag) {
+  auto lock = this->lock_index(true);
+  if (this->cartridge_entries.empty()) {
+    return {};
+  }
+
+  if (!etag.has_value()) {
+    return this->cartridge_entries;
+  }
+
+  if (etag.value() == this->cartridges_etag) {
+    return CartridgesResult { .etag = this->cartridges_etag, .unchanged = true, .cartridges = {} };
+  }
+  return CartridgesResult { .etag = this->cartridges_etag, .unchanged = false, .cartridges = this->cartridge_entries };
+}
+
+std::optional<ModuleDependents> LSP::handle_dependents(const std::string& uri, bool transitive) {
+  auto key = cartridge_key(this->from_uri(uri));
+  if (!key.has_value()) {
+    return {};
+  }
 
+  ModuleDependents result { .module = key.value(), .dependents = {} };
+  for (const auto& path : this->require_graph.dependents(key.value(), transitive)) {
+    result.dependents.push_back(this->to_uri(path));
   }
+  return result;
+}
 
+static bool is_word_char(char c) {
+  return std::isalnum((unsigned char)c) || c == '_' || c == '$';
+}
+
+// the path of a `require('...')` on the line when `column` is inside of its quotes
+static std::optional<std::string_view> require_specifier_at(std::string_view line, size_t column) {
+  for (size_t at = line.find("require"); at != std::string_view::npos; at = line.find("require", at + 1)) {
+    if (at > 0 && is_word_char(line[at - 1])) {
+      continue;
+    }
+
+    size_t i = line.find_first_not_of(" \t", at + 7);
+    if (i == std::string_view::npos || line[i] != '(') {
+      continue;
+    }
+    i = line.find_first_not_of(" \t", i + 1);
+    if (i == std::string_view::npos || (line[i] != '\'' && line[i] != '"' && line[i] != '`')) {
+      continue;
+    }
+    size_t close = line.find(line[i], i + 1);
+    if (close != std::string_view::npos && column > i && column <= close) {
+      return line.substr(i + 1, close - i - 1);
+    }
+  }
   return {};
 }
 
-std::optional<std::vector<CartridgeEntry>> LSP::handle_cartridges(json request) {
-  std::vector<CartridgeEntry> cartridges_list;
-  workspace::cartridges cartridges;
-  workspace::traverse(this->current_path, cartridges);
+std::optional<ModuleTarget> LSP::target_at(const Document& document, const std::string& uri, Position position) {
+  std::string path = this->from_uri(uri);
+  std::string scratch;
+  std::string_view line = document.line_view(position.line, scratch);
+  size_t column = utf16_offset(line, position.character < 0 ? 0 : position.character);
+
+  auto specifier = require_specifier_at(line, column);
+  if (specifier.has_value()) {
+    return (ModuleTarget) { .key = RequireGraph::module_key(path, specifier.value()), .member = "" };
+  }
 
-  if (cartridges.empty()) {
+  size_t start = column;
+  size_t end = column;
+  while (start > 0 && is_word_char(line[start - 1])) {
+    start--;
+  }
+  while (end < line.size() && is_word_char(line[end])) {
+    end++;
+  }
+  if (start == end) {
     return {};
   }
+  std::string_view word = line.substr(start, end - start);
 
-  for (const auto& cartridge : cartridges) {
-    cartridges_list.push_back((CartridgeEntry) {
-        .file_path = cartridge.second,
-        .file_name = cartridge.first,
+  // key of the module a variable was assigned from
+  const auto& symbols = document.get_symbols();
+  auto required = [&path, &symbols](std::string_view name) -> std::optional<std::string> {
+    if (symbols == nullptr) {
+      return {};
+    }
+    auto symbol = symbols->find(std::string(name));
+    if (symbol == symbols->end() || symbol->second.require.empty()) {
+      return {};
+    }
+    return RequireGraph::module_key(path, symbol->second.require);
+  };
+
+  // `helpers.calc`
+  if (start > 0 && line[start - 1] == '.') {
+    size_t object_start = start - 1;
+    while (object_start > 0 && is_word_char(line[object_start - 1])) {
+      object_start--;
+    }
+    auto key = required(line.substr(object_start, start - 1 - object_start));
+    if (key.has_value()) {
+      return (ModuleTarget) { .key = key.value(), .member = std::string(word) };
+    }
+  }
+
+  auto key = required(word);
+  if (key.has_value()) {
+    return (ModuleTarget) { .key = key.value(), .member = "" };
+  }
+
+  // an export written in this module
+  auto own_key = cartridge_key(path);
+  auto exported = this->exports.find(path, word);
+  if (own_key.has_value() && exported.has_value() && exported->line == (uint32_t)position.line) {
+    return (ModuleTarget) { .key = own_key.value(), .member = std::string(word) };
+  }
+  return {};
+}
+
+static Range reference_range(uint32_t line, uint32_t start, uint32_t end) {
+  return (Range) {
+    .start = { .line = (int)line, .character = (int)start },
+    .end = { .line = (int)line, .character = (int)end },
+  };
+}
+
+// references come from the files on disk, unsaved changes of open documents are not in the graph yet
+std::vector<Location> LSP::handle_references(const ModuleTarget& target, bool include_declaration) {
+  std::vector<Location> locations;
+  if (include_declaration && target.key.starts_with("/cartridge/") && target.key.ends_with(".js")) {
+    std::string require = "*" + target.key.substr(0, target.key.size() - 3);
+    locations = this->goto_required_module(require, true, target.member).value_or(std::vector<Location> {});
+  }
+
+  auto references = target.member.empty() ? this->require_graph.references(target.key) : this->require_graph.member_references(target.key, target.member);
+  for (const auto& reference : references) {
+    locations.push_back((Location) { .uri = this->to_uri(reference.path), .range = reference_range(reference.line, reference.start, reference.end) });
+  }
+  return locations;
+}
+
+// the module file the platform would load for the key, nothing for the dw api or anything else outside of the cartridges
+std::optional<CallHierarchyItem> LSP::module_item(const ModuleTarget& target) {
+  std::string path;
+  {
+    auto lock = this->lock_index(true);
+    auto chain = this->index.fc.lookup(target.key);
+    if (chain.empty()) {
+      return {};
+    }
+    path = chain.front();
+  }
+
+  Range range = this->member_range(path, target.member);
+  return (CallHierarchyItem) {
+    .name = target.member.empty() ? std::filesystem::path(path).filename().string() : target.member,
+    .kind = target.member.empty() ? SYMBOL_KIND_MODULE : SYMBOL_KIND_FUNCTION,
+    .detail = target.key,
+    .uri = this->to_uri(path),
+    .range = range,
+    .selectionRange = range,
+    .data = target,
+  };
+}
+
+CallHierarchyItem LSP::file_item(const std::string& path) {
+  std::string key = cartridge_key(path).value_or(path);
+  Range top = reference_range(0, 0, 0);
+  return (CallHierarchyItem) {
+    .name = std::filesystem::path(path).filename().string(),
+    .kind = SYMBOL_KIND_MODULE,
+    .detail = key,
+    .uri = this->to_uri(path),
+    .range = top,
+    .selectionRange = top,
+    .data = { .key = key, .member = "" },
+  };
+}
+
+// the files requiring the module, or using the member, each with the ranges it does so at
+std::vector<CallHierarchyIncomingCall> LSP::handle_incoming_calls(const CallHierarchyItem& item) {
+  const ModuleTarget& target = item.data;
+  auto references = target.member.empty() ? this->require_graph.references(target.key) : this->require_graph.member_references(target.key, target.member);
+
+  std::map<std::string, std::vector<Range>> callers;
+  for (const auto& reference : references) {
+    callers[reference.path].push_back(reference_range(reference.line, reference.start, reference.end));
+  }
+
+  std::vector<CallHierarchyIncomingCall> calls;
+  for (auto& [path, ranges] : callers) {
+    calls.push_back((CallHierarchyIncomingCall) { .from = this->file_item(path), .fromRanges = std::move(ranges) });
+  }
+  return calls;
+}
+
+// the modules the item's file requires, the dw api and other modules outside of the cartridges are left out
+std::vector<CallHierarchyOutgoingCall> LSP::handle_outgoing_calls(const CallHierarchyItem& item) {
+  std::vector<CallHierarchyOutgoingCall> calls;
+  std::map<std::string, size_t> by_key;
+  for (const auto& dependency : this->require_graph.dependencies(this->from_uri(item.uri))) {
+    const RequireSite& site = dependency.site;
+    auto it = by_key.find(dependency.key);
+    if (it != by_key.end()) {
+      calls[it->second].fromRanges.push_back(reference_range(site.line, site.start, site.end));
+      continue;
+    }
+
+    auto to = this->module_item((ModuleTarget) { .key = dependency.key, .member = "" });
+    if (!to.has_value()) {
+      continue;
+    }
+    by_key.insert({dependency.key, calls.size()});
+    calls.push_back((CallHierarchyOutgoingCall) { .to = to.value(), .fromRanges = { reference_range(site.line, site.start, site.end) } });
+  }
+  return calls;
+}
+
+std::vector<SymbolInformation> LSP::handle_workspace_symbol(std::string_view query) {
+  std::vector<SymbolInformation> symbols;
+  for (const auto& match : this->workspace_symbols.search(query, WORKSPACE_SYMBOL_LIMIT)) {
+    const Declaration& declaration = match.declaration;
+    symbols.push_back((SymbolInformation) {
+        .name = declaration.name,
+        .kind = declaration.kind,
+        .location = { .uri = this->to_uri(match.path), .range = reference_range(declaration.line, declaration.start, declaration.end) },
+        .containerName = cartridge_name(match.path),
         });
   }
+  return symbols;
+}
+
+std::shared_ptr<const Document> LSP::snapshot(Document& document) {
+  if (document.get_symbols() == nullptr) {
+    document.set_symbols(this->ts.build_symbols(document));
+  }
+
+  // later edits must not show up halfway through, the copy shares the text and symbols and gets its own tree
+  return std::make_shared<const Document>(document);
+}
+
+static std::string serialize(const json& result) {
+  return result.dump(-1, ' ', false, json::error_handler_t::replace);
+}
+
+// queues a read-only request on the workers. `handle` returns the serialized result, or nothing when there
+// is no response. cancelled requests are answered with an error instead, whether they got to run or not.
+void LSP::dispatch(const json& id, std::string supersede_key, std::function<std::optional<std::string>()> handle) {
+  this->dispatcher.submit(id.dump(), std::move(supersede_key), [this, id, handle](const CancelToken& cancelled) {
+      if (!cancelled->load()) {
+        auto result = handle();
+        if (!cancelled->load()) {
+          if (result.has_value()) {
+            this->respond_result(id, result.value());
+          }
+          return;
+        }
+      }
+
+      this->respond(ErrorResponseMessage{ .id = id, .error = { .code = REQUEST_CANCELLED, .message = "Request cancelled" } });
+      });
+}
+
+enum Method {
+  METHOD_UNKNOWN,
+  METHOD_INITIALIZE,
+  METHOD_INITIALIZED,
+  METHOD_COMPLETION,
+  METHOD_DEFINITION,
+  METHOD_IMPLEMENTATION,
+  METHOD_CARTRIDGES,
+  METHOD_DEPENDENTS,
+  METHOD_REFERENCES,
+  METHOD_PREPARE_CALL_HIERARCHY,
+  METHOD_INCOMING_CALLS,
+  METHOD_OUTGOING_CALLS,
+  METHOD_WORKSPACE_SYMBOL,
+  METHOD_CANCEL_REQUEST,
+  METHOD_DID_CHANGE_WATCHED_FILES,
+  METHOD_DID_OPEN,
+  METHOD_DID_CHANGE,
+  METHOD_DID_CLOSE,
+};
+
+// one hash and at most one compare per message. two methods with the same hash would be duplicate
+// case labels and not compile, the compare only keeps unknown methods from matching by accident.
+#define METHOD_CASE(name, method) case fnv1a(name): return str == name ? method : METHOD_UNKNOWN;
+
+static Method method_of(const json& message) {
+  auto it = message.find("method");
+  if (it == message.end() || !it->is_string()) {
+    return METHOD_UNKNOWN;
+  }
+
+  std::string_view str = it->get_ref<const std::string&>();
+  switch (fnv1a(str)) {
+    METHOD_CASE("initialize", METHOD_INITIALIZE)
+    METHOD_CASE("initialized", METHOD_INITIALIZED)
+    METHOD_CASE("textDocument/completion", METHOD_COMPLETION)
+    METHOD_CASE("textDocument/definition", METHOD_DEFINITION)
+    METHOD_CASE("textDocument/implementation", METHOD_IMPLEMENTATION)
+    METHOD_CASE("sfcc-lsp/workspace/cartridges", METHOD_CARTRIDGES)
+    METHOD_CASE("sfcc-lsp/module/dependents", METHOD_DEPENDENTS)
+    METHOD_CASE("textDocument/references", METHOD_REFERENCES)
+    METHOD_CASE("textDocument/prepareCallHierarchy", METHOD_PREPARE_CALL_HIERARCHY)
+    METHOD_CASE("callHierarchy/incomingCalls", METHOD_INCOMING_CALLS)
+    METHOD_CASE("callHierarchy/outgoingCalls", METHOD_OUTGOING_CALLS)
+    METHOD_CASE("workspace/symbol", METHOD_WORKSPACE_SYMBOL)
+    METHOD_CASE("$/cancelRequest", METHOD_CANCEL_REQUEST)
+    METHOD_CASE("workspace/didChangeWatchedFiles", METHOD_DID_CHANGE_WATCHED_FILES)
+    METHOD_CASE("textDocument/didOpen", METHOD_DID_OPEN)
+    METHOD_CASE("textDocument/didChange", METHOD_DID_CHANGE)
+    METHOD_CASE("textDocument/didClose", METHOD_DID_CLOSE)
+    default: return METHOD_UNKNOWN;
+  }
+}
+
+#undef METHOD_CASE
+
+// answers to the requests the server sent, only the progress token creation is waited on
+void LSP::handle_response(const json& response) {
+  auto id = response.find("id");
+  if (id == response.end() || *id != INDEXING_PROGRESS_TOKEN) {
+    return;
+  }
 
-  return cartridges_list;
+  if (response.contains("error") || !response.contains("result")) {
+    this->log(LOG_INFO, "The client did not create the indexing progress token, indexing runs without progress");
+    return;
+  }
+  this->activate_progress(INDEXING_PROGRESS_TOKEN);
 }
 
-std::optional<json> LSP::handle_request(json request) {
-    if (request["method"] == "initialize") {
-      return ResponseMessage<InitializeResult>(request["id"], InitializeResult("my-custom-sfcc-lsp", "0.0.1"));
-    } 
+std::optional<json> LSP::handle_request(const json& request) {
+  if (!request.contains("method")) {
+    this->handle_response(request);
+    return {};
+  }
+
+  Method method = method_of(request);
+  const json& id = request.at("id");
+  static const json no_params = json::object();
+  auto params_it = request.find("params");
+  const json& params = params_it == request.end() ? no_params : *params_it;
+
+  switch (method) {
+    case METHOD_INITIALIZE: {
+      // a second one would start another indexer over the running one
+      if (this->initialize_received) {
+        return ErrorResponseMessage{ .id = id, .error = { .code = INVALID_REQUEST, .message = "Server is already initialized" } };
+      }
+      this->initialize_received = true;
+      this->start_indexing(params);
+      return ResponseMessage<InitializeResult>(id, InitializeResult("my-custom-sfcc-lsp", "0.0.1"));
+    }
+
+    case METHOD_COMPLETION: {
+      auto position = params.template get<TextDocumentPositionParams>();
+      // only the word or require path being typed matters, there is no need to hold on to the document
+      std::string word;
+      std::optional<std::string> require;
+      Document* document = this->get_document(position.textDocument.uri);
+      if (document != nullptr) {
+        std::string scratch;
+        std::string_view line = document->line_view(position.position.line, scratch);
+        size_t column = utf16_offset(line, position.position.character < 0 ? 0 : position.position.character);
+        auto argument = CompletionEngine::require_argument_before(line, column);
+        if (argument.has_value()) {
+          require = std::string(argument.value());
+        } else {
+          word = CompletionEngine::word_before(line, column);
+        }
+      }
+
+      // the trigger characters only mean something inside of a require
+      auto context = params.find("context");
+      bool triggered = context != params.end() && context->is_object() && context->value("triggerKind", 1) == 2;
 
-    if (request["method"] == "textDocument/completion") {
-      return ResponseMessage<CompletionList>(request["id"], this->handle_completion(request));
+      Position cursor = position.position;
+      this->dispatch(id, "textDocument/completion " + position.textDocument.uri, [this, word, require, cursor, triggered]() -> std::optional<std::string> {
+          if (require.has_value()) {
+            return serialize(this->handle_require_completion(require.value(), cursor));
+          }
+          if (triggered) {
+            return serialize(CompletionList { .isIncomplete = false, .items = {} });
+          }
+          return this->handle_completion(word);
+          });
+      return {};
     }
 
-    if (request["method"] == "textDocument/definition") {
-      auto location = this->handle_definition(request);
-      if (!location.has_value()) {
+    case METHOD_DEFINITION:
+    case METHOD_IMPLEMENTATION: {
+      auto position = params.template get<TextDocumentPositionParams>();
+      Document* document = this->get_document(position.textDocument.uri);
+      if (document == nullptr) {
         return {};
       }
 
-      return ResponseMessage<std::vector<Location>>(request["id"], location.value());
+      auto snapshot = this->snapshot(*document);
+      bool all_overrides = method == METHOD_IMPLEMENTATION;
+      std::string supersede_key = (all_overrides ? "textDocument/implementation " : "textDocument/definition ") + position.textDocument.uri;
+      this->dispatch(id, supersede_key, [this, snapshot, position, all_overrides]() -> std::optional<std::string> {
+          auto location = this->handle_definition(*snapshot, position.position, all_overrides);
+          if (!location.has_value()) {
+            return "null";
+          }
+          return serialize(location.value());
+          });
+      return {};
     }
 
-    if (request["method"] == "sfcc-lsp/workspace/cartridges") {
-      auto location = this->handle_cartridges(request);
-      if (!location.has_value()) {
+    case METHOD_CARTRIDGES: {
+      std::optional<std::string> etag;
+      if (params.contains("etag") && params["etag"].is_string()) {
+        etag = params["etag"].template get<std::string>();
+      }
+
+      this->dispatch(id, "", [this, etag]() -> std::optional<std::string> {
+          auto location = this->handle_cartridges(etag);
+          if (!location.has_value()) {
+            return "null";
+          }
+          return serialize(location.value());
+          });
+      return {};
+    }
+
+    case METHOD_DEPENDENTS: {
+      auto document = params.at("textDocument").template get<TextDocumentIdentifier>();
+      bool transitive = params.value("transitive", false);
+
+      this->dispatch(id, "", [this, document, transitive]() -> std::optional<std::string> {
+          auto dependents = this->handle_dependents(document.uri, transitive);
+          if (!dependents.has_value()) {
+            return "null";
+          }
+          return serialize(dependents.value());
+          });
+      return {};
+    }
+
+    case METHOD_REFERENCES: {
+      auto position = params.template get<TextDocumentPositionParams>();
+      Document* document = this->get_document(position.textDocument.uri);
+      if (document == nullptr) {
         return {};
       }
-      return ResponseMessage<std::vector<CartridgeEntry>>(request["id"], location.value());
+      bool include_declaration = params.value("/context/includeDeclaration"_json_pointer, false);
+
+      auto snapshot = this->snapshot(*document);
+      this->dispatch(id, "textDocument/references " + position.textDocument.uri, [this, snapshot, position, include_declaration]() -> std::optional<std::string> {
+          auto target = this->target_at(*snapshot, position.textDocument.uri, position.position);
+          if (!target.has_value()) {
+            return "null";
+          }
+          return serialize(this->handle_references(target.value(), include_declaration));
+          });
+      return {};
     }
 
-    return {};
+    case METHOD_PREPARE_CALL_HIERARCHY: {
+      auto position = params.template get<TextDocumentPositionParams>();
+      Document* document = this->get_document(position.textDocument.uri);
+      if (document == nullptr) {
+        return {};
+      }
+
+      auto snapshot = this->snapshot(*document);
+      this->dispatch(id, "textDocument/prepareCallHierarchy " + position.textDocument.uri, [this, snapshot, position]() -> std::optional<std::string> {
+          auto target = this->target_at(*snapshot, position.textDocument.uri, position.position);
+          auto item = target.has_value() ? this->module_item(target.value()) : std::nullopt;
+          if (!item.has_value()) {
+            return "null";
+          }
+          return serialize(std::vector<CallHierarchyItem> { item.value() });
+          });
+      return {};
+    }
+
+    case METHOD_INCOMING_CALLS:
+    case METHOD_OUTGOING_CALLS: {
+      auto item = params.at("item").template get<CallHierarchyItem>();
+      bool incoming = method == METHOD_INCOMING_CALLS;
+      this->dispatch(id, "", [this, item, incoming]() -> std::optional<std::string> {
+          if (incoming) {
+            return serialize(this->handle_incoming_calls(item));
+          }
+          return serialize(this->handle_outgoing_calls(item));
+          });
+      return {};
+    }
+
+    case METHOD_WORKSPACE_SYMBOL: {
+      std::string query = params.value("query", "");
+      // every keystroke sends a new query, the older ones are dropped
+      this->dispatch(id, "workspace/symbol", [this, query]() -> std::optional<std::string> {
+          return serialize(this->handle_workspace_symbol(query));
+          });
+      return {};
+    }
+
+    default:
+      return {};
+  }
+}
+
+// document text is moved out of the message instead of copied, it is the biggest part of most notifications
+static std::string take_text(json& change) {
+  return std::move(change.at("text").get_ref<std::string&>());
 }
 
-void LSP::handle_notification(json request) {
-    if (request["method"] == "textDocument/didChange") {
-      auto didChangeNotification = request.template get<NotificationMessage<DidChangeTextDocumentParams>>();
-      for (auto& element : didChangeNotification.params.contentChanges) {
-        this->documents.insert({didChangeNotification.params.textDocument.uri, element.text});
+void LSP::handle_notification(json&& notification) {
+  Method method = method_of(notification);
+  auto params_it = notification.find("params");
+  json no_params = json::object();
+  json& params = params_it == notification.end() ? no_params : *params_it;
+
+  switch (method) {
+    case METHOD_INITIALIZED: {
+      // servers may only create progress tokens once the client is initialized,
+      // the token is used once the client answered, see handle_response
+      if (this->client_supports_progress) {
+        this->send(RequestMessage<WorkDoneProgressCreateParams>{
+            .id = INDEXING_PROGRESS_TOKEN,
+            .method = "window/workDoneProgress/create",
+            .params = { .token = INDEXING_PROGRESS_TOKEN },
+            });
       }
+
+      this->register_watched_files(true);
+      return;
+    }
+
+    case METHOD_CANCEL_REQUEST: {
+      this->dispatcher.cancel(params.at("id").dump());
+      return;
     }
 
-    if (request["method"] == "textDocument/didOpen") {
-      auto didOpenNotification = request.template get<NotificationMessage<DidOpenTextDocumentParams>>();
-      this->documents.insert({didOpenNotification.params.textDocument.uri, didOpenNotification.params.textDocument.text});
+    case METHOD_DID_CHANGE_WATCHED_FILES: {
+      auto changes = params.template get<DidChangeWatchedFilesParams>();
+      std::vector<FileEvent> events;
+      for (const auto& change : changes.changes) {
+        events.push_back((FileEvent) {
+            .path = this->from_uri(change.uri),
+            .type = (FileEventType)change.type,
+            .is_directory = false,
+            });
+      }
+      this->watcher.add_events(std::move(events));
+      return;
     }
+
+    case METHOD_DID_CHANGE: {
+      auto text_document = params.at("textDocument").template get<TextDocument>();
+      Document* document = this->get_document(text_document.uri);
+      if (document == nullptr) {
+        return;
+      }
+
+      for (auto& change : params.at("contentChanges")) {
+        auto range = change.find("range");
+        if (range != change.end()) {
+          document->apply_change(range->template get<Range>(), take_text(change));
+        } else {
+          document->replace(take_text(change));
+        }
+      }
+      document->set_version(text_document.version);
+      this->ts.parse(*document);
+      return;
+    }
+
+    case METHOD_DID_OPEN: {
+      json& item = params.at("textDocument");
+      std::string uri = item.at("uri");
+      auto [it, inserted] = this->documents.insert_or_assign(std::move(uri), Document(take_text(item), item.at("version")));
+      this->ts.parse(it->second);
+      return;
+    }
+
+    case METHOD_DID_CLOSE: {
+      auto closed = params.template get<DidCloseTextDocumentParams>();
+      this->documents.erase(closed.textDocument.uri);
+      return;
+    }
+
+    default:
+      return;
+  }
 }
@@ -14,51 +14,46 @@
 using json = nlohmann::json;
 
 int main(void) {
-  setvbuf(stdin, NULL, _IONBF, 0);
-  
   auto current_path = std::filesystem::current_path();
   auto current_path_str = current_path.string();
-  std::vector<lsp::CompletionItem> items = COMPLETION_REQUIRE_ITEMS;
-  lsp::LSP lsp(items, current_path_str);
+  lsp::LSP lsp(lsp::COMPLETION_ENTRIES, current_path_str);
 
   current_path_str.push_back('/');
-  lsp.log_file << "Starting lsp in " << current_path << std::endl;
+  lsp.log(lsp::LOG_INFO, "Starting lsp in " + current_path.string());
 
+  json request;
   while (true) {
-    std::string content_length_line;
-    std::getline(std::cin, content_length_line, '\r'); std::cin.get();
-    // eating up the remaining not needed bytes
-    std::cin.get(); std::cin.get();
-
-    std::string content_length_str = content_length_line.substr(
-        content_length_line.find(":") + 2, content_length_line.size());
-
-    int content_length = std::atoi(content_length_str.c_str());
-
-    char* request_str = (char*)malloc((content_length + 1) * sizeof(char));
-    memset(request_str, '\0', sizeof(char) * content_length + 1);
-
-    std::cin.read(request_str, content_length);
-    lsp.log_file << "[REQUEST]: " << request_str << std::endl;
+    lsp::ReadResult result = lsp.transport.read(request);
+    if (result == lsp::READ_CLOSED) {
+      lsp.log(lsp::LOG_INFO, "Client closed the connection");
+      break;
+    }
 
-    if (!json::accept(request_str)) {
-      lsp.log_file << "[ERROR]: Invalid request json." << std::endl;
+    if (lsp.log_enabled(lsp::LOG_TRACE)) {
+      lsp.log(lsp::LOG_TRACE, "[REQUEST]: ", lsp.transport.last_body());
+    }
+    if (result == lsp::READ_INVALID) {
+      lsp.log(lsp::LOG_ERROR, "Invalid request json.");
       continue;
     }
 
-    json request = json::parse(request_str);
-    if (request.contains("id")) {
-      auto response = lsp.handle_request(request);
-      if (response.has_value()) {
-        std::cout << "Content-Length: " << response.value().dump().size() << "\r\n\r\n" << response.value().dump();
-        lsp.log_file << "[RESPONSE]: " << response.value().dump() << std::endl;
+    // a message missing something the handler needs is dropped, it must not take the server down
+    try {
+      if (request.contains("id")) {
+        auto response = lsp.handle_request(request);
+        if (response.has_value()) {
+          lsp.respond(response.value());
+        }
+      } else {
+        lsp.handle_notification(std::move(request));
+      }
+    } catch (const json::exception& e) {
+      lsp.log(lsp::LOG_ERROR, std::string("Malformed message, ") + e.what());
+      // the client would wait on the id forever, responses from the client have no method and get no answer
+      if (request.contains("id") && request.contains("method")) {
+        lsp.respond(lsp::ErrorResponseMessage{ .id = request["id"], .error = { .code = lsp::INVALID_PARAMS, .message = e.what() } });
       }
-    } else {
-      lsp.handle_notification(request);
     }
-
-    memset(request_str, '\0', sizeof(char) * content_length);
-    free(request_str);
   }
 
   return 0;
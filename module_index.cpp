@@ -0,0 +1,239 @@
+#include "module_index.hpp"
+#include "hash.hpp"
+#include <cstring>
+#include <fstream>
+#include <atomic>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace lsp;
+
+static const char MODULE_INDEX_MAGIC[8] = { 'S', 'F', 'C', 'C', 'M', 'O', 'D', '\0' };
+
+std::optional<FileStamp> lsp::file_stamp(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    return {};
+  }
+  return (FileStamp) {
+    .mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec,
+    .size = (uint64_t)st.st_size,
+  };
+}
+
+std::filesystem::path lsp::module_index_path(const std::filesystem::path& data_dir, const std::string& root) {
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.modules", (unsigned long long)fnv1a(root));
+  return data_dir / name;
+}
+
+namespace {
+// records have no fixed size, every field is written in order and strings are prefixed with their length
+class Writer {
+  public:
+    std::string data;
+
+    template <typename T>
+    void put(T value) {
+      this->data.append((const char*)&value, sizeof(T));
+    }
+
+    void put(std::string_view str) {
+      this->put((uint32_t)str.size());
+      this->data.append(str);
+    }
+};
+
+class Reader {
+  private:
+    std::string_view data;
+    size_t offset = 0;
+
+  public:
+    bool failed = false;
+
+    Reader(std::string_view data) : data(data) {}
+
+    template <typename T>
+    T get() {
+      T value = {};
+      if (this->failed || this->data.size() - this->offset < sizeof(T)) {
+        this->failed = true;
+        return value;
+      }
+      memcpy(&value, this->data.data() + this->offset, sizeof(T));
+      this->offset += sizeof(T);
+      return value;
+    }
+
+    std::string get_string() {
+      uint32_t length = this->get<uint32_t>();
+      if (this->failed || this->data.size() - this->offset < length) {
+        this->failed = true;
+        return "";
+      }
+      std::string str(this->data.substr(this->offset, length));
+      this->offset += length;
+      return str;
+    }
+
+    // counts come from the file, a broken one must not reserve gigabytes
+    uint32_t get_count() {
+      uint32_t count = this->get<uint32_t>();
+      if (count > this->data.size() - this->offset) {
+        this->failed = true;
+        return 0;
+      }
+      return count;
+    }
+
+    bool done() const { return this->offset == this->data.size(); }
+};
+}
+
+bool lsp::save_module_index(const std::filesystem::path& index_path, const std::string& root, const std::vector<ModuleRecord>& records) {
+  Writer out;
+  out.data.append(MODULE_INDEX_MAGIC, sizeof(MODULE_INDEX_MAGIC));
+  out.put(MODULE_INDEX_VERSION);
+  out.put(std::string_view(root));
+  out.put((uint32_t)records.size());
+
+  for (const auto& record : records) {
+    std::string_view path = record.path;
+    if (path.starts_with(root)) {
+      path.remove_prefix(root.size());
+    }
+    out.put(path);
+    out.put(record.stamp.mtime);
+    out.put(record.stamp.size);
+
+    out.put((uint32_t)record.exports.size());
+    for (const auto& [name, exported] : record.exports) {
+      out.put(std::string_view(name));
+      out.put(exported.line);
+      out.put(exported.start);
+      out.put(exported.end);
+      out.put(exported.target_line);
+      out.put(exported.target_start);
+      out.put(exported.target_end);
+    }
+
+    out.put((uint32_t)record.sites.size());
+    for (const auto& site : record.sites) {
+      out.put(std::string_view(site.specifier));
+      out.put(site.line);
+      out.put(site.start);
+      out.put(site.end);
+      out.put((uint32_t)site.members.size());
+      for (const auto& use : site.members) {
+        out.put(std::string_view(use.name));
+        out.put(use.line);
+        out.put(use.start);
+        out.put(use.end);
+      }
+    }
+
+    out.put((uint32_t)record.declarations.size());
+    for (const auto& declaration : record.declarations) {
+      out.put(std::string_view(declaration.name));
+      out.put((int32_t)declaration.kind);
+      out.put(declaration.line);
+      out.put(declaration.start);
+      out.put(declaration.end);
+    }
+  }
+
+  // written next to the real index and renamed over it, so a crash never leaves half an index behind.
+  // the name is unique to the process and the write, another server on the same workspace has its own
+  static std::atomic<uint64_t> writes = 0;
+  std::filesystem::path tmp_path = index_path;
+  tmp_path += "." + std::to_string(getpid()) + "." + std::to_string(writes++) + ".tmp";
+  std::error_code ec;
+  std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    return false;
+  }
+  file.write(out.data.data(), out.data.size());
+  file.close();
+  if (file.fail()) {
+    std::filesystem::remove(tmp_path, ec);
+    return false;
+  }
+
+  std::filesystem::rename(tmp_path, index_path, ec);
+  if (ec) {
+    std::error_code remove_ec;
+    std::filesystem::remove(tmp_path, remove_ec);
+    return false;
+  }
+  return true;
+}
+
+std::optional<std::vector<ModuleRecord>> lsp::load_module_index(const std::filesystem::path& index_path, const std::string& root) {
+  std::ifstream file(index_path, std::ios::binary);
+  if (!file.is_open()) {
+    return {};
+  }
+  std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (data.size() < sizeof(MODULE_INDEX_MAGIC) || memcmp(data.data(), MODULE_INDEX_MAGIC, sizeof(MODULE_INDEX_MAGIC)) != 0) {
+    return {};
+  }
+
+  Reader in(std::string_view(data).substr(sizeof(MODULE_INDEX_MAGIC)));
+  if (in.get<uint32_t>() != MODULE_INDEX_VERSION || in.get_string() != root) {
+    return {};
+  }
+
+  std::vector<ModuleRecord> records(in.get_count());
+  for (auto& record : records) {
+    record.path = root + in.get_string();
+    record.stamp.mtime = in.get<int64_t>();
+    record.stamp.size = in.get<uint64_t>();
+
+    uint32_t export_count = in.get_count();
+    for (uint32_t i = 0; i < export_count && !in.failed; ++i) {
+      std::string name = in.get_string();
+      Export exported;
+      exported.line = in.get<uint32_t>();
+      exported.start = in.get<uint32_t>();
+      exported.end = in.get<uint32_t>();
+      exported.target_line = in.get<uint32_t>();
+      exported.target_start = in.get<uint32_t>();
+      exported.target_end = in.get<uint32_t>();
+      record.exports.insert({std::move(name), std::move(exported)});
+    }
+
+    record.sites.resize(in.get_count());
+    for (auto& site : record.sites) {
+      site.specifier = in.get_string();
+      site.line = in.get<uint32_t>();
+      site.start = in.get<uint32_t>();
+      site.end = in.get<uint32_t>();
+      site.members.resize(in.get_count());
+      for (auto& use : site.members) {
+        use.name = in.get_string();
+        use.line = in.get<uint32_t>();
+        use.start = in.get<uint32_t>();
+        use.end = in.get<uint32_t>();
+      }
+    }
+
+    record.declarations.resize(in.get_count());
+    for (auto& declaration : record.declarations) {
+      declaration.name = in.get_string();
+      declaration.kind = in.get<int32_t>();
+      declaration.line = in.get<uint32_t>();
+      declaration.start = in.get<uint32_t>();
+      declaration.end = in.get<uint32_t>();
+    }
+
+    if (in.failed) {
+      return {};
+    }
+  }
+
+  if (in.failed || !in.done()) {
+    return {};
+  }
+  return records;
+}
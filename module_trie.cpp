@@ -0,0 +1,212 @@
+#include "module_trie.hpp"
+#include <algorithm>
+#include <cctype>
+#include <tuple>
+#include <completion.hpp>
+#include <file_cache.hpp>
+
+using namespace lsp;
+
+static const std::string_view KEY_PREFIX = "/cartridge/";
+static const std::string_view MODULE_EXTENSION = ".js";
+// prefix matches always rank above fuzzy ones
+static const int PREFIX_SCORE = 1000;
+
+static std::string fold(std::string_view str) {
+  std::string folded(str);
+  for (char& c : folded) {
+    c = std::tolower((unsigned char)c);
+  }
+  return folded;
+}
+
+// `/cartridge/a/b.js` -> `a/b`
+static bool module_path(std::string_view key, std::string_view& path) {
+  if (!key.starts_with(KEY_PREFIX) || !key.ends_with(MODULE_EXTENSION) || key.size() <= KEY_PREFIX.size() + MODULE_EXTENSION.size()) {
+    return false;
+  }
+  path = key.substr(KEY_PREFIX.size(), key.size() - KEY_PREFIX.size() - MODULE_EXTENSION.size());
+  return true;
+}
+
+// calls `fn` with every non-empty segment, stops as soon as it returns false
+template <typename Fn>
+static bool for_each_segment(std::string_view path, Fn fn) {
+  size_t start = 0;
+  while (start < path.size()) {
+    size_t end = std::min(path.find('/', start), path.size());
+    if (end > start && !fn(path.substr(start, end - start))) {
+      return false;
+    }
+    start = end + 1;
+  }
+  return true;
+}
+
+ModuleTrie::ModuleTrie() {
+  this->clear();
+}
+
+void ModuleTrie::clear() {
+  this->nodes.clear();
+  this->free_nodes.clear();
+  this->nodes.push_back((Node) { .name = "", .folded = "", .parent = NO_ID, .children = {}, .modules = 0, .terminal = 0 });
+}
+
+uint32_t ModuleTrie::find_child(uint32_t node, std::string_view name) const {
+  const auto& children = this->nodes[node].children;
+  std::string folded = fold(name);
+  auto it = std::lower_bound(children.begin(), children.end(), name, [this, &folded](uint32_t child, std::string_view name) {
+      return std::tie(this->nodes[child].folded, this->nodes[child].name) < std::tie(folded, name);
+      });
+  if (it == children.end() || this->nodes[*it].name != name) {
+    return NO_ID;
+  }
+  return *it;
+}
+
+uint32_t ModuleTrie::add_child(uint32_t node, std::string_view name) {
+  uint32_t child = this->find_child(node, name);
+  if (child != NO_ID) {
+    return child;
+  }
+
+  Node entry = { .name = std::string(name), .folded = fold(name), .parent = node, .children = {}, .modules = 0, .terminal = 0 };
+  if (!this->free_nodes.empty()) {
+    child = this->free_nodes.back();
+    this->free_nodes.pop_back();
+    this->nodes[child] = std::move(entry);
+  } else {
+    child = this->nodes.size();
+    this->nodes.push_back(std::move(entry));
+  }
+
+  auto& children = this->nodes[node].children;
+  const Node& added = this->nodes[child];
+  auto it = std::lower_bound(children.begin(), children.end(), child, [this, &added](uint32_t a, uint32_t) {
+      return std::tie(this->nodes[a].folded, this->nodes[a].name) < std::tie(added.folded, added.name);
+      });
+  children.insert(it, child);
+  return child;
+}
+
+void ModuleTrie::insert(std::string_view key) {
+  std::string_view path;
+  if (!module_path(key, path)) {
+    return;
+  }
+
+  uint32_t node = 0;
+  this->nodes[node].modules++;
+  for_each_segment(path, [this, &node](std::string_view segment) {
+      node = this->add_child(node, segment);
+      this->nodes[node].modules++;
+      return true;
+      });
+  this->nodes[node].terminal++;
+}
+
+void ModuleTrie::remove(std::string_view key) {
+  std::string_view path;
+  if (!module_path(key, path)) {
+    return;
+  }
+
+  uint32_t node = 0;
+  bool found = for_each_segment(path, [this, &node](std::string_view segment) {
+      node = this->find_child(node, segment);
+      return node != NO_ID;
+      });
+  if (!found || node == 0 || this->nodes[node].terminal == 0) {
+    return;
+  }
+
+  this->nodes[node].terminal--;
+  for (; node != NO_ID; node = this->nodes[node].parent) {
+    if (--this->nodes[node].modules > 0 || node == 0) {
+      continue;
+    }
+
+    auto& siblings = this->nodes[this->nodes[node].parent].children;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+    this->nodes[node].children.clear();
+    this->free_nodes.push_back(node);
+  }
+}
+
+ModuleCompletions ModuleTrie::complete(std::string_view directory, std::string_view partial, size_t limit) const {
+  ModuleCompletions result;
+  uint32_t node = 0;
+  bool found = for_each_segment(directory, [this, &node](std::string_view segment) {
+      node = this->find_child(node, segment);
+      return node != NO_ID;
+      });
+  if (!found) {
+    return result;
+  }
+
+  const auto& children = this->nodes[node].children;
+  std::string pattern = fold(partial);
+  auto begin = std::lower_bound(children.begin(), children.end(), pattern, [this](uint32_t child, const std::string& pattern) {
+      return this->nodes[child].folded < pattern;
+      });
+  auto end = begin;
+  while (end != children.end() && this->nodes[*end].folded.starts_with(pattern)) {
+    ++end;
+  }
+
+  // (score, child) pairs, a child that is a directory and a module at once shows up as both
+  std::vector<std::pair<int, uint32_t>> scored;
+  for (auto it = begin; it != end; ++it) {
+    const Node& child = this->nodes[*it];
+    // shorter names and exact case win among the prefix matches, with nothing typed yet the busiest directories do
+    int score = PREFIX_SCORE;
+    if (!pattern.empty()) {
+      score -= child.folded.size() - pattern.size();
+      if (child.name.starts_with(partial)) {
+        score += 50;
+      }
+    }
+    scored.push_back({score, *it});
+  }
+
+  // with enough prefix matches the fuzzy ones would never make it into the result
+  if (scored.size() < limit) {
+    for (auto it = children.begin(); it != children.end(); ++it) {
+      if (it >= begin && it < end) {
+        continue;
+      }
+      const Node& child = this->nodes[*it];
+      auto score = CompletionEngine::fuzzy_score(pattern, child.name, child.folded);
+      if (score.has_value()) {
+        scored.push_back({score.value(), *it});
+      }
+    }
+  }
+
+  size_t count = std::min(scored.size(), limit);
+  // higher scores first, then the busier directories, then alphabetical
+  std::partial_sort(scored.begin(), scored.begin() + count, scored.end(), [this](const auto& a, const auto& b) {
+      if (a.first != b.first) {
+        return a.first > b.first;
+      }
+      const Node& node_a = this->nodes[a.second];
+      const Node& node_b = this->nodes[b.second];
+      if (node_a.modules != node_b.modules) {
+        return node_a.modules > node_b.modules;
+      }
+      return std::tie(node_a.folded, node_a.name) < std::tie(node_b.folded, node_b.name);
+      });
+
+  result.incomplete = scored.size() > count;
+  for (size_t i = 0; i < count; ++i) {
+    const Node& child = this->nodes[scored[i].second];
+    if (child.terminal > 0) {
+      result.items.push_back((ModuleCompletion) { .name = child.name, .directory = false, .modules = child.terminal });
+    }
+    if (child.modules > child.terminal) {
+      result.items.push_back((ModuleCompletion) { .name = child.name, .directory = true, .modules = child.modules - child.terminal });
+    }
+  }
+  return result;
+}
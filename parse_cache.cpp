@@ -0,0 +1,111 @@
+#include "parse_cache.hpp"
+#include <fstream>
+#include <sys/stat.h>
+#include <treesitter.hpp>
+
+using namespace lsp;
+
+// rough size of one node of a tree, tree-sitter does not report what a tree takes
+static const size_t NODE_BYTES = 64;
+
+ParsedFile::ParsedFile(std::string path, std::string source, TSTree* tree, int64_t mtime) :
+  path(std::move(path)),
+  source(std::move(source)),
+  tree(tree),
+  mtime(mtime)
+{
+  this->bytes = this->source.size() + ts_node_descendant_count(ts_tree_root_node(tree)) * NODE_BYTES;
+}
+
+ParseCache::ParseCache(size_t budget) : budget(budget) {}
+
+std::shared_ptr<const ParsedFile> ParseCache::get(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    this->invalidate(path);
+    return nullptr;
+  }
+  int64_t mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+
+  size_t budget;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    budget = this->budget;
+    auto it = this->entries.find(path);
+    if (it != this->entries.end()) {
+      const auto& parsed = *it->second;
+      if (parsed->mtime == mtime && parsed->source.size() == (size_t)st.st_size) {
+        this->lru.splice(this->lru.begin(), this->lru, it->second);
+        return parsed;
+      }
+
+      this->used -= parsed->bytes;
+      this->lru.erase(it->second);
+      this->entries.erase(it);
+    }
+  }
+
+  // read and parsed without the lock, two threads missing on the same file both parse it and the later one is kept
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return nullptr;
+  }
+  std::string source((size_t)st.st_size, '\0');
+  file.read(source.data(), source.size());
+  source.resize(file.gcount());
+
+  TSTree* tree = parse_source(source);
+  if (tree == nullptr) {
+    return nullptr;
+  }
+  auto parsed = std::make_shared<const ParsedFile>(path, std::move(source), tree, mtime);
+  // it would push everything else out and then itself, the caller gets to use it once
+  if (parsed->bytes > budget) {
+    return parsed;
+  }
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto it = this->entries.find(path);
+  if (it != this->entries.end()) {
+    this->used -= (*it->second)->bytes;
+    this->lru.erase(it->second);
+    this->entries.erase(it);
+  }
+  this->lru.push_front(parsed);
+  this->entries.insert({path, this->lru.begin()});
+  this->used += parsed->bytes;
+  this->evict();
+  return parsed;
+}
+
+// has to be called with the mutex held
+void ParseCache::evict() {
+  while (this->used > this->budget && !this->lru.empty()) {
+    const auto& oldest = this->lru.back();
+    this->used -= oldest->bytes;
+    this->entries.erase(oldest->path);
+    this->lru.pop_back();
+  }
+}
+
+void ParseCache::invalidate(const std::string& path) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto it = this->entries.find(path);
+  if (it == this->entries.end()) {
+    return;
+  }
+  this->used -= (*it->second)->bytes;
+  this->lru.erase(it->second);
+  this->entries.erase(it);
+}
+
+void ParseCache::set_budget(size_t budget) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->budget = budget;
+  this->evict();
+}
+
+size_t ParseCache::size() const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->used;
+}
@@ -0,0 +1,113 @@
+#include "queries.hpp"
+
+extern "C" const TSLanguage* tree_sitter_javascript(void);
+
+using namespace lsp;
+
+// keeps a handful of cursors around, enough for the requests that can run at the same time
+static const size_t MAX_POOLED_CURSORS = 16;
+
+static const char* QUERY_SOURCES[QUERY_COUNT] = {
+  // QUERY_REQUIRE_LINE
+  "(variable_declarator name: (identifier) @required_vname value: (call_expression function: (identifier) arguments: (arguments (string(string_fragment) @cartridge_fpath))))",
+  // QUERY_MEMBER_EXPRESSION
+  "(member_expression object: (identifier) property: (property_identifier)) @member_expr",
+  // QUERY_VARIABLE_DECLARATION
+  "[ (variable_declaration (variable_declarator name: (identifier) @name) @declarator) (lexical_declaration (variable_declarator name: (identifier) @name) @declarator) (function_declaration name: (identifier) @name) @declarator ]",
+  // QUERY_EXPORT_ASSIGNMENT
+  "(assignment_expression left: (member_expression) @left right: (_) @right)",
+  // QUERY_REQUIRE_CALL
+  "(call_expression function: (identifier) @function arguments: (arguments . (string (string_fragment) @path))) @call",
+};
+
+static const char* QUERY_NAMES[QUERY_COUNT] = {
+  "require line",
+  "member expression",
+  "variable declaration",
+  "export assignment",
+  "require call",
+};
+
+static const char* query_error_name(TSQueryError error) {
+  switch (error) {
+    case TSQueryErrorSyntax: return "syntax error";
+    case TSQueryErrorNodeType: return "unknown node type";
+    case TSQueryErrorField: return "unknown field";
+    case TSQueryErrorCapture: return "unknown capture";
+    case TSQueryErrorStructure: return "impossible pattern";
+    case TSQueryErrorLanguage: return "language mismatch";
+    default: return "error";
+  }
+}
+
+uint32_t CompiledQuery::capture_id(std::string_view name) const {
+  for (uint32_t i = 0; i < this->capture_names.size(); ++i) {
+    if (this->capture_names[i] == name) {
+      return i;
+    }
+  }
+  return NO_CAPTURE;
+}
+
+QueryRegistry::QueryRegistry() {
+  const TSLanguage* lang = tree_sitter_javascript();
+
+  for (size_t id = 0; id < QUERY_COUNT; ++id) {
+    std::string_view source = QUERY_SOURCES[id];
+    uint32_t err_offset;
+    TSQueryError err_type;
+    TSQuery* query = ts_query_new(lang, source.data(), source.size(), &err_offset, &err_type);
+    // the users check for a null query, the error is kept for whoever has a logger
+    if (err_type != TSQueryErrorNone) {
+      this->compile_errors.push_back(std::string("The ") + QUERY_NAMES[id] + " query does not compile, "
+          + query_error_name(err_type) + " at offset " + std::to_string(err_offset));
+      continue;
+    }
+
+    CompiledQuery& compiled = this->queries[id];
+    compiled.query = query;
+    for (uint32_t i = 0; i < ts_query_capture_count(query); ++i) {
+      uint32_t len;
+      const char* name = ts_query_capture_name_for_id(query, i, &len);
+      compiled.capture_names.push_back(std::string(name, len));
+    }
+  }
+}
+
+QueryRegistry::~QueryRegistry() {
+  for (auto& compiled : this->queries) {
+    if (compiled.query != nullptr) {
+      ts_query_delete(compiled.query);
+    }
+  }
+
+  for (auto cursor : this->cursors) {
+    ts_query_cursor_delete(cursor);
+  }
+}
+
+QueryRegistry& QueryRegistry::instance() {
+  static QueryRegistry registry;
+  return registry;
+}
+
+TSQueryCursor* QueryRegistry::acquire_cursor() {
+  {
+    std::lock_guard<std::mutex> lock(this->cursors_mutex);
+    if (!this->cursors.empty()) {
+      TSQueryCursor* cursor = this->cursors.back();
+      this->cursors.pop_back();
+      return cursor;
+    }
+  }
+  return ts_query_cursor_new();
+}
+
+void QueryRegistry::release_cursor(TSQueryCursor* cursor) {
+  std::lock_guard<std::mutex> lock(this->cursors_mutex);
+  if (this->cursors.size() >= MAX_POOLED_CURSORS) {
+    ts_query_cursor_delete(cursor);
+    return;
+  }
+  this->cursors.push_back(cursor);
+}
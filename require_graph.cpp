@@ -0,0 +1,189 @@
+#include "require_graph.hpp"
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <file_cache.hpp>
+
+using namespace lsp;
+
+// what node resolution would try first for a path without an extension
+static std::string with_extension(std::string path) {
+  if (!path.ends_with(".js") && !path.ends_with(".json")) {
+    path.append(".js");
+  }
+  return path;
+}
+
+std::string RequireGraph::module_key(const std::string& from, std::string_view specifier) {
+  if (specifier.starts_with("*/") || specifier.starts_with("~/")) {
+    return with_extension(std::string(specifier.substr(1)));
+  }
+
+  if (specifier.starts_with("./") || specifier.starts_with("../")) {
+    std::string path = with_extension((std::filesystem::path(from).parent_path() / specifier).lexically_normal().string());
+    return cartridge_key(path).value_or(path);
+  }
+
+  return std::string(specifier);
+}
+
+// has to be called with the mutex held exclusively
+void RequireGraph::unlink(const std::string& path) {
+  auto it = this->forward.find(path);
+  if (it == this->forward.end()) {
+    return;
+  }
+
+  for (const auto& dependency : it->second.dependencies) {
+    auto dependents = this->reverse.find(dependency.key);
+    if (dependents == this->reverse.end()) {
+      continue;
+    }
+    dependents->second.erase(path);
+    if (dependents->second.empty()) {
+      this->reverse.erase(dependents);
+    }
+  }
+  this->forward.erase(it);
+}
+
+void RequireGraph::set(const std::string& path, FileStamp stamp, std::vector<RequireSite> sites, bool replace) {
+  std::vector<Dependency> dependencies;
+  dependencies.reserve(sites.size());
+  for (auto& site : sites) {
+    std::string key = module_key(path, site.specifier);
+    dependencies.push_back((Dependency) { .key = std::move(key), .site = std::move(site) });
+  }
+
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  if (this->forward.contains(path)) {
+    if (!replace) {
+      return;
+    }
+    this->unlink(path);
+  }
+
+  for (const auto& dependency : dependencies) {
+    this->reverse[dependency.key].insert(path);
+  }
+  this->forward.insert({path, (Requires) { .stamp = stamp, .dependencies = std::move(dependencies) }});
+}
+
+void RequireGraph::remove(const std::string& path) {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  this->unlink(path);
+}
+
+void RequireGraph::remove_under(const std::vector<std::string>& directories) {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  std::vector<std::string> removed;
+  for (const auto& [path, entry] : this->forward) {
+    for (const auto& directory : directories) {
+      if (path.size() > directory.size() && path.starts_with(directory) && path[directory.size()] == '/') {
+        removed.push_back(path);
+        break;
+      }
+    }
+  }
+
+  for (const auto& path : removed) {
+    this->unlink(path);
+  }
+}
+
+void RequireGraph::clear() {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  this->forward.clear();
+  this->reverse.clear();
+}
+
+std::vector<Dependency> RequireGraph::dependencies(const std::string& path) const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  auto it = this->forward.find(path);
+  if (it == this->forward.end()) {
+    return {};
+  }
+  return it->second.dependencies;
+}
+
+std::vector<std::string> RequireGraph::dependents(const std::string& key, bool transitive) const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  std::set<std::string> seen;
+  std::deque<std::string> keys = { key };
+  std::set<std::string> visited_keys = { key };
+
+  // breadth first over the reverse edges, every file that shows up is a module others can require in turn
+  while (!keys.empty()) {
+    auto it = this->reverse.find(keys.front());
+    keys.pop_front();
+    if (it == this->reverse.end()) {
+      continue;
+    }
+
+    for (const auto& path : it->second) {
+      if (!seen.insert(path).second || !transitive) {
+        continue;
+      }
+      auto next = cartridge_key(path);
+      if (next.has_value() && visited_keys.insert(next.value()).second) {
+        keys.push_back(next.value());
+      }
+    }
+  }
+
+  return std::vector<std::string>(seen.begin(), seen.end());
+}
+
+std::vector<Reference> RequireGraph::references(const std::string& key) const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  std::vector<Reference> references;
+  auto dependents = this->reverse.find(key);
+  if (dependents == this->reverse.end()) {
+    return references;
+  }
+
+  for (const auto& path : dependents->second) {
+    for (const auto& dependency : this->forward.at(path).dependencies) {
+      if (dependency.key == key) {
+        const RequireSite& site = dependency.site;
+        references.push_back((Reference) { .path = path, .line = site.line, .start = site.start, .end = site.end });
+      }
+    }
+  }
+  return references;
+}
+
+std::vector<Reference> RequireGraph::member_references(const std::string& key, std::string_view member) const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  std::vector<Reference> references;
+  auto dependents = this->reverse.find(key);
+  if (dependents == this->reverse.end()) {
+    return references;
+  }
+
+  for (const auto& path : dependents->second) {
+    for (const auto& dependency : this->forward.at(path).dependencies) {
+      if (dependency.key != key) {
+        continue;
+      }
+      for (const auto& use : dependency.site.members) {
+        if (use.name == member) {
+          references.push_back((Reference) { .path = path, .line = use.line, .start = use.start, .end = use.end });
+        }
+      }
+    }
+  }
+  return references;
+}
+
+void RequireGraph::for_each(const std::function<void(const std::string&, const FileStamp&, const std::vector<Dependency>&)>& visit) const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  for (const auto& [path, entry] : this->forward) {
+    visit(path, entry.stamp, entry.dependencies);
+  }
+}
+
+size_t RequireGraph::size() const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  return this->forward.size();
+}
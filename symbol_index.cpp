@@ -0,0 +1,263 @@
+#include "symbol_index.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <completion.hpp>
+
+using namespace lsp;
+
+// scores of the substring tiers, fuzzy matches stay below all of them
+static const int EXACT_SCORE = 4000;
+static const int FOLDED_EXACT_SCORE = 3500;
+static const int PREFIX_SCORE = 3000;
+static const int WORD_START_SCORE = 2500;
+static const int SUBSTRING_SCORE = 2000;
+static const int MAX_FUZZY_SCORE = 1999;
+// tombstones are only swept once there are this many of them and more than live entries
+static const size_t MIN_COMPACT = 1024;
+
+static std::string fold(std::string_view str) {
+  std::string folded(str);
+  for (char& c : folded) {
+    c = std::tolower((unsigned char)c);
+  }
+  return folded;
+}
+
+static uint32_t trigram(std::string_view str, size_t i) {
+  return ((uint32_t)(unsigned char)str[i] << 16) | ((uint32_t)(unsigned char)str[i + 1] << 8) | (uint32_t)(unsigned char)str[i + 2];
+}
+
+// has to be called with the mutex held exclusively
+void SymbolIndex::add(uint32_t file, Declaration declaration) {
+  uint32_t id = this->entries.size();
+  std::string folded = fold(declaration.name);
+  for (size_t i = 0; i + 3 <= folded.size(); ++i) {
+    auto& posting = this->postings[trigram(folded, i)];
+    // a trigram repeating in one name is posted once
+    if (posting.empty() || posting.back() != id) {
+      posting.push_back(id);
+    }
+  }
+
+  this->entries.push_back((Entry) { .declaration = std::move(declaration), .folded = std::move(folded), .file = file });
+  this->file_entries[file].push_back(id);
+}
+
+// has to be called with the mutex held exclusively
+void SymbolIndex::unlink(uint32_t file) {
+  for (uint32_t id : this->file_entries[file]) {
+    Entry& entry = this->entries[id];
+    entry.file = NO_FILE;
+    entry.declaration.name = std::string();
+    entry.folded = std::string();
+    this->dead++;
+  }
+  this->file_entries[file].clear();
+}
+
+// rebuilds the entries and postings without the dead entries, ids keep their relative order
+void SymbolIndex::compact() {
+  std::vector<Entry> entries = std::move(this->entries);
+  this->entries.clear();
+  this->postings.clear();
+  for (auto& ids : this->file_entries) {
+    ids.clear();
+  }
+  this->dead = 0;
+
+  for (auto& entry : entries) {
+    if (entry.file != NO_FILE) {
+      this->add(entry.file, std::move(entry.declaration));
+    }
+  }
+}
+
+void SymbolIndex::set(const std::string& path, std::vector<Declaration> declarations, bool replace) {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  auto it = this->file_ids.find(path);
+  uint32_t file;
+  if (it != this->file_ids.end()) {
+    file = it->second;
+    if (!this->file_entries[file].empty() && !replace) {
+      return;
+    }
+    this->unlink(file);
+  } else {
+    file = this->files.size();
+    this->files.push_back(path);
+    this->file_entries.emplace_back();
+    this->file_ids.insert({path, file});
+  }
+
+  for (auto& declaration : declarations) {
+    this->add(file, std::move(declaration));
+  }
+  if (this->dead >= MIN_COMPACT && this->dead > this->entries.size() - this->dead) {
+    this->compact();
+  }
+}
+
+void SymbolIndex::remove(const std::string& path) {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  auto it = this->file_ids.find(path);
+  if (it != this->file_ids.end()) {
+    this->unlink(it->second);
+  }
+}
+
+void SymbolIndex::remove_under(const std::vector<std::string>& directories) {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  for (uint32_t file = 0; file < this->files.size(); ++file) {
+    const std::string& path = this->files[file];
+    for (const auto& directory : directories) {
+      if (path.size() > directory.size() && path.starts_with(directory) && path[directory.size()] == '/') {
+        this->unlink(file);
+        break;
+      }
+    }
+  }
+}
+
+void SymbolIndex::clear() {
+  std::unique_lock<std::shared_mutex> lock(this->mutex);
+  this->entries.clear();
+  this->files.clear();
+  this->file_entries.clear();
+  this->file_ids.clear();
+  this->postings.clear();
+  this->dead = 0;
+}
+
+std::vector<Declaration> SymbolIndex::get(const std::string& path) const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  std::vector<Declaration> declarations;
+  auto it = this->file_ids.find(path);
+  if (it == this->file_ids.end()) {
+    return declarations;
+  }
+  for (uint32_t id : this->file_entries[it->second]) {
+    declarations.push_back(this->entries[id].declaration);
+  }
+  return declarations;
+}
+
+// where `pattern`, the lowercased `query`, occurs in the name. an occurrence at a word start wins over the first one
+static std::optional<int> substring_score(std::string_view query, std::string_view pattern, const std::string& name, const std::string& folded) {
+  if (name == query) {
+    return EXACT_SCORE;
+  }
+  if (folded == pattern) {
+    return FOLDED_EXACT_SCORE;
+  }
+
+  size_t at = folded.find(pattern);
+  if (at == std::string::npos) {
+    return {};
+  }
+  // shorter names are closer to what was typed
+  int penalty = std::min((int)(folded.size() - pattern.size()), 400);
+  if (at == 0) {
+    return PREFIX_SCORE - penalty;
+  }
+
+  for (size_t i = at; i != std::string::npos; i = folded.find(pattern, i + 1)) {
+    if (!std::isalnum((unsigned char)name[i - 1]) || (std::isupper((unsigned char)name[i]) && std::islower((unsigned char)name[i - 1]))) {
+      return WORD_START_SCORE - penalty;
+    }
+  }
+  return SUBSTRING_SCORE - penalty;
+}
+
+std::vector<SymbolMatch> SymbolIndex::search(std::string_view query, size_t limit) const {
+  std::string pattern = fold(query);
+  std::vector<std::pair<int, uint32_t>> scored;
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+
+  // names containing the query. with three characters or more only the entries in every posting list of
+  // the query are looked at, the shortest list is the starting point and every other one narrows it down
+  if (pattern.size() >= 3) {
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (size_t i = 0; i + 3 <= pattern.size(); ++i) {
+      auto posting = this->postings.find(trigram(pattern, i));
+      if (posting == this->postings.end()) {
+        lists.clear();
+        break;
+      }
+      lists.push_back(&posting->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+    std::vector<uint32_t> candidates = lists.empty() ? std::vector<uint32_t> {} : *lists.front();
+    std::vector<uint32_t> narrowed;
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+      narrowed.clear();
+      std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(narrowed));
+      std::swap(candidates, narrowed);
+    }
+
+    for (uint32_t id : candidates) {
+      const Entry& entry = this->entries[id];
+      if (entry.file == NO_FILE) {
+        continue;
+      }
+      auto score = substring_score(query, pattern, entry.declaration.name, entry.folded);
+      if (score.has_value()) {
+        scored.push_back({score.value(), id});
+      }
+    }
+  }
+
+  // short queries and too few substring matches fall back to a scan. a name that contains
+  // the query was either scored above or is scored as a substring here
+  if (scored.size() < limit) {
+    bool substrings_done = pattern.size() >= 3;
+    for (uint32_t id = 0; id < this->entries.size(); ++id) {
+      const Entry& entry = this->entries[id];
+      if (entry.file == NO_FILE) {
+        continue;
+      }
+      if (entry.folded.find(pattern) != std::string::npos) {
+        if (!substrings_done) {
+          scored.push_back({substring_score(query, pattern, entry.declaration.name, entry.folded).value(), id});
+        }
+        continue;
+      }
+      auto score = CompletionEngine::fuzzy_score(pattern, entry.declaration.name, entry.folded);
+      if (score.has_value()) {
+        scored.push_back({std::min(score.value(), MAX_FUZZY_SCORE), id});
+      }
+    }
+  }
+
+  size_t count = std::min(scored.size(), limit);
+  std::partial_sort(scored.begin(), scored.begin() + count, scored.end(), [this](const auto& a, const auto& b) {
+      if (a.first != b.first) {
+        return a.first > b.first;
+      }
+      const Entry& entry_a = this->entries[a.second];
+      const Entry& entry_b = this->entries[b.second];
+      if (entry_a.folded.size() != entry_b.folded.size()) {
+        return entry_a.folded.size() < entry_b.folded.size();
+      }
+      if (entry_a.declaration.name != entry_b.declaration.name) {
+        return entry_a.declaration.name < entry_b.declaration.name;
+      }
+      return this->files[entry_a.file] < this->files[entry_b.file];
+      });
+
+  std::vector<SymbolMatch> matches;
+  matches.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const Entry& entry = this->entries[scored[i].second];
+    matches.push_back((SymbolMatch) { .declaration = entry.declaration, .path = this->files[entry.file] });
+  }
+  return matches;
+}
+
+size_t SymbolIndex::size() const {
+  std::shared_lock<std::shared_mutex> lock(this->mutex);
+  return this->entries.size() - this->dead;
+}
@@ -0,0 +1,86 @@
+#include <cassert>
+#include <string>
+#include "lsp.hpp"
+#include "document.hpp"
+
+using namespace lsp;
+
+static Range range(int start_line, int start_character, int end_line, int end_character) {
+  return (Range) {
+    .start = { .line = start_line, .character = start_character },
+    .end = { .line = end_line, .character = end_character },
+  };
+}
+
+// `a`, two byte `é`, four byte `😀` that is two utf-16 units, `b`
+static const std::string MIXED = "a\xC3\xA9\xF0\x9F\x98\x80" "b";
+
+static void test_utf16_offset() {
+  assert(utf16_offset(MIXED, 0) == 0);
+  assert(utf16_offset(MIXED, 1) == 1);
+  assert(utf16_offset(MIXED, 2) == 3);
+  // halfway through the surrogate pair stays before the character
+  assert(utf16_offset(MIXED, 3) == 3);
+  assert(utf16_offset(MIXED, 4) == 7);
+  assert(utf16_offset(MIXED, 5) == 8);
+  assert(utf16_offset(MIXED, 100) == 8);
+  assert(utf16_length(MIXED) == 5);
+}
+
+static void test_apply_change() {
+  Document document("hello\nworld", 1);
+  document.apply_change(range(0, 5, 0, 5), " there");
+  assert(document.text() == "hello there\nworld");
+  assert(document.line_count() == 2);
+
+  // across the line break
+  document.apply_change(range(0, 3, 1, 2), "X");
+  assert(document.text() == "helXrld");
+  assert(document.line_count() == 1);
+
+  // inserted lines move everything after them
+  document.apply_change(range(0, 0, 0, 0), "one\ntwo\n");
+  assert(document.text() == "one\ntwo\nhelXrld");
+  assert(document.line_count() == 3);
+  assert(document.size() == document.text().size());
+
+  // deleting everything
+  document.apply_change(range(0, 0, 2, 7), "");
+  assert(document.text() == "");
+  assert(document.line_count() == 1);
+}
+
+static void test_apply_change_utf16() {
+  Document document(MIXED + "\n" + MIXED, 1);
+  // after the emoji on the second line
+  document.apply_change(range(1, 4, 1, 4), "!");
+  assert(document.line(1) == "a\xC3\xA9\xF0\x9F\x98\x80!b");
+  // the emoji itself
+  document.apply_change(range(0, 2, 0, 4), "");
+  assert(document.line(0) == "a\xC3\xA9" "b");
+}
+
+static void test_line_view() {
+  Document document("first\nsecond\nthird", 1);
+  std::string scratch;
+  assert(document.line_view(0, scratch) == "first");
+  assert(document.line_view(2, scratch) == "third");
+
+  // the edit splits the second line over three pieces
+  document.apply_change(range(1, 3, 1, 3), "-middle-");
+  assert(document.line_view(1, scratch) == "sec-middle-ond");
+  assert(document.line_view(0, scratch) == "first");
+  assert(document.line_view(2, scratch) == "third");
+  assert(document.line_view(3, scratch) == "");
+  for (size_t i = 0; i < document.line_count(); ++i) {
+    assert(document.line_view(i, scratch) == document.line(i));
+  }
+}
+
+int main(void) {
+  test_utf16_offset();
+  test_apply_change();
+  test_apply_change_utf16();
+  test_line_view();
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include <cassert>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "module_index.hpp"
+
+using namespace lsp;
+
+static const std::string ROOT = "/workspace/";
+
+static std::vector<ModuleRecord> sample_records() {
+  ModuleRecord record;
+  record.path = ROOT + "carts/app/cartridge/scripts/helpers/basketHelpers.js";
+  record.stamp = { .mtime = 1700000000, .size = 512 };
+  record.exports["calc"] = (Export) { .line = 10, .start = 4, .end = 8, .target_line = 2, .target_start = 9, .target_end = 13 };
+  record.sites.push_back((RequireSite) {
+      .specifier = "*/cartridge/models/basket",
+      .line = 0,
+      .start = 20,
+      .end = 45,
+      .members = { (MemberUse) { .name = "total", .line = 3, .start = 11, .end = 16 } },
+      });
+  record.declarations.push_back((Declaration) { .name = "calc", .kind = SYMBOL_KIND_FUNCTION, .line = 2, .start = 9, .end = 13 });
+  return { record, (ModuleRecord) { .path = ROOT + "carts/app/cartridge/models/basket.js", .stamp = { .mtime = 1, .size = 0 }, .exports = {}, .sites = {}, .declarations = {} } };
+}
+
+static std::string read_file(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+static void write_file(const std::filesystem::path& path, std::string_view data) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(data.data(), data.size());
+}
+
+static void test_round_trip(const std::filesystem::path& path) {
+  assert(save_module_index(path, ROOT, sample_records()));
+  auto loaded = load_module_index(path, ROOT);
+  assert(loaded.has_value());
+  assert(loaded->size() == 2);
+
+  const ModuleRecord& record = loaded->at(0);
+  assert(record.path == sample_records()[0].path);
+  assert(record.stamp == sample_records()[0].stamp);
+  const Export& exported = record.exports.at("calc");
+  assert(exported.line == 10 && exported.start == 4 && exported.end == 8);
+  assert(exported.target_line == 2 && exported.target_start == 9 && exported.target_end == 13);
+  assert(record.sites.size() == 1);
+  assert(record.sites[0].specifier == "*/cartridge/models/basket");
+  assert(record.sites[0].members.size() == 1 && record.sites[0].members[0].name == "total");
+  assert(record.declarations.size() == 1 && record.declarations[0].name == "calc");
+
+  // another workspace never gets this one
+  assert(!load_module_index(path, "/elsewhere/").has_value());
+}
+
+static void test_rejects_truncated(const std::filesystem::path& path) {
+  assert(save_module_index(path, ROOT, sample_records()));
+  std::string data = read_file(path);
+  assert(!data.empty());
+
+  std::filesystem::path cut = path.string() + ".cut";
+  for (size_t size = 0; size < data.size(); ++size) {
+    write_file(cut, std::string_view(data).substr(0, size));
+    assert(!load_module_index(cut, ROOT).has_value());
+  }
+
+  // anything after the last record is just as wrong
+  write_file(cut, data + "x");
+  assert(!load_module_index(cut, ROOT).has_value());
+  std::filesystem::remove(cut);
+
+  assert(!load_module_index(path.string() + ".missing", ROOT).has_value());
+}
+
+int main(void) {
+  std::filesystem::path dir = std::filesystem::temp_directory_path() / ("sfcc-lsp-module-index-test-" + std::to_string(getpid()));
+  std::filesystem::create_directories(dir);
+  std::filesystem::path path = dir / "test.modules";
+
+  test_round_trip(path);
+  test_rejects_truncated(path);
+
+  std::filesystem::remove_all(dir);
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <cassert>
+#include <string>
+#include "module_trie.hpp"
+
+using namespace lsp;
+
+static bool has(const ModuleCompletions& completions, std::string_view name, bool directory, uint32_t modules) {
+  for (const auto& item : completions.items) {
+    if (item.name == name && item.directory == directory && item.modules == modules) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void test_insert_complete() {
+  ModuleTrie trie;
+  trie.insert("/cartridge/scripts/helpers/basketHelpers.js");
+  trie.insert("/cartridge/scripts/helpers/cartHelpers.js");
+  trie.insert("/cartridge/scripts/util.js");
+  trie.insert("/cartridge/models/basket.js");
+  // not a module
+  trie.insert("/cartridge/templates/default/cart.isml");
+
+  auto top = trie.complete("", "", 10);
+  assert(top.items.size() == 2);
+  assert(has(top, "scripts", true, 3));
+  assert(has(top, "models", true, 1));
+  assert(!top.incomplete);
+
+  auto scripts = trie.complete("scripts", "", 10);
+  assert(has(scripts, "helpers", true, 2));
+  assert(has(scripts, "util", false, 1));
+
+  auto helpers = trie.complete("scripts/helpers", "bask", 10);
+  assert(!helpers.items.empty());
+  assert(helpers.items[0].name == "basketHelpers");
+
+  // the limit cuts the list and says so
+  auto limited = trie.complete("scripts/helpers", "", 1);
+  assert(limited.items.size() == 1);
+  assert(limited.incomplete);
+
+  assert(trie.complete("nowhere", "", 10).items.empty());
+}
+
+static void test_overrides() {
+  ModuleTrie trie;
+  // the same key from two cartridges
+  trie.insert("/cartridge/models/basket.js");
+  trie.insert("/cartridge/models/basket.js");
+  trie.remove("/cartridge/models/basket.js");
+  assert(has(trie.complete("models", "", 10), "basket", false, 1));
+  trie.remove("/cartridge/models/basket.js");
+  assert(trie.complete("", "", 10).items.empty());
+}
+
+static void test_remove_round_trip() {
+  ModuleTrie trie;
+  trie.insert("/cartridge/scripts/helpers/basketHelpers.js");
+  trie.insert("/cartridge/scripts/util.js");
+
+  trie.remove("/cartridge/scripts/helpers/basketHelpers.js");
+  auto scripts = trie.complete("scripts", "", 10);
+  assert(scripts.items.size() == 1);
+  assert(has(scripts, "util", false, 1));
+  assert(trie.complete("scripts/helpers", "", 10).items.empty());
+
+  // removing what is not there changes nothing
+  trie.remove("/cartridge/scripts/helpers/basketHelpers.js");
+  trie.remove("/cartridge/scripts/missing.js");
+  assert(has(trie.complete("", "", 10), "scripts", true, 1));
+
+  // freed nodes are used again
+  trie.insert("/cartridge/scripts/helpers/basketHelpers.js");
+  assert(has(trie.complete("scripts/helpers", "", 10), "basketHelpers", false, 1));
+  assert(has(trie.complete("", "", 10), "scripts", true, 2));
+
+  trie.clear();
+  assert(trie.complete("", "", 10).items.empty());
+}
+
+int main(void) {
+  test_insert_complete();
+  test_overrides();
+  test_remove_round_trip();
+  return 0;
+}
@@ -0,0 +1,61 @@
+// generates items.hpp, the completion table, from the list of dw api modules. one module path per
+// line, empty lines and lines starting with # are skipped.
+//
+//   generate_items data/dw_api_modules.txt > items.hpp
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static std::string escape(const std::string& str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped.push_back('\\');
+    }
+    escaped.push_back(c);
+  }
+  return escaped;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " <modules file>" << std::endl;
+    return 1;
+  }
+
+  std::ifstream in(argv[1]);
+  if (!in.is_open()) {
+    std::cerr << "could not open " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::cout << "// generated by tools/generate_items.cpp from " << argv[1] << ", do not edit\n"
+    << "#ifndef SFCC_ITEMS_HPP_\n"
+    << "#define SFCC_ITEMS_HPP_\n\n"
+    << "#include <completion.hpp>\n\n"
+    << "namespace lsp {\n"
+    << "  inline constexpr CompletionEntry COMPLETION_ENTRIES[] = {\n";
+
+  std::string line;
+  while (std::getline(in, line)) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+      line.pop_back();
+    }
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    std::string name = line.substr(line.rfind('/') + 1);
+    std::string label = "req" + name;
+    std::string insert_text = "const " + name + " = require('" + line + "');";
+    // keys in the order nlohmann would write them
+    std::string fragment = "{\"insertText\":\"" + escape(insert_text) + "\",\"label\":\"" + escape(label) + "\"}";
+
+    std::cout << "    { \"" << escape(label) << "\", \"" << escape(fragment) << "\" },\n";
+  }
+
+  std::cout << "  };\n"
+    << "}\n\n"
+    << "#endif // SFCC_ITEMS_HPP_\n";
+  return 0;
+}
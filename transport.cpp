@@ -0,0 +1,203 @@
+#include "transport.hpp"
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <sys/uio.h>
+
+using namespace lsp;
+
+static const size_t INITIAL_BUFFER_SIZE = 64 * 1024;
+
+// appends the serialization of `value` to `out`, keeping its capacity. json::dump can only return a new
+// string, so this is the one place that goes through nlohmann's internal serializer, which the public dump
+// wraps the same way. documents can hold anything, invalid utf-8 is replaced instead of taking the server down
+static void dump_into(std::string& out, const json& value) {
+  nlohmann::detail::serializer<json> serializer(nlohmann::detail::output_adapter<char>(out), ' ', json::error_handler_t::replace);
+  serializer.dump(value, false, false, 0);
+}
+
+static std::string_view trim(std::string_view str) {
+  while (!str.empty() && (str.front() == ' ' || str.front() == '\t' || str.front() == '\r')) {
+    str.remove_prefix(1);
+  }
+  while (!str.empty() && (str.back() == ' ' || str.back() == '\t' || str.back() == '\r')) {
+    str.remove_suffix(1);
+  }
+  return str;
+}
+
+static bool equals_ignore_case(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (std::tolower((unsigned char)a[i]) != std::tolower((unsigned char)b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Transport::Transport(int in_fd, int out_fd) : in_fd(in_fd), out_fd(out_fd), buffer(INITIAL_BUFFER_SIZE) {}
+
+// reads whatever is available into the free space at the end of the buffer, making room first
+bool Transport::fill() {
+  if (this->end == this->buffer.size()) {
+    if (this->start > 0) {
+      memmove(this->buffer.data(), this->buffer.data() + this->start, this->end - this->start);
+      this->end -= this->start;
+      this->start = 0;
+    } else {
+      this->buffer.resize(this->buffer.size() * 2);
+    }
+  }
+
+  while (true) {
+    ssize_t len = ::read(this->in_fd, this->buffer.data() + this->end, this->buffer.size() - this->end);
+    if (len < 0 && errno == EINTR) {
+      continue;
+    }
+    if (len <= 0) {
+      return false;
+    }
+    this->end += len;
+    return true;
+  }
+}
+
+// Content-Length is the only header that matters, Content-Type can only ever be utf-8 json
+std::optional<size_t> Transport::parse_headers(std::string_view headers) {
+  std::optional<size_t> content_length;
+  while (!headers.empty()) {
+    size_t newline = headers.find('\n');
+    std::string_view line = headers.substr(0, newline);
+    headers.remove_prefix(newline == std::string_view::npos ? headers.size() : newline + 1);
+
+    size_t colon = line.find(':');
+    if (colon == std::string_view::npos || !equals_ignore_case(trim(line.substr(0, colon)), "Content-Length")) {
+      continue;
+    }
+
+    std::string_view value = trim(line.substr(colon + 1));
+    size_t length;
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), length);
+    if (ec != std::errc() || ptr != value.data() + value.size()) {
+      return {};
+    }
+    content_length = length;
+  }
+  return content_length;
+}
+
+ReadResult Transport::read(json& message) {
+  this->body = {};
+
+  // headers end at the first empty line, some clients terminate lines with a bare \n
+  size_t header_length;
+  size_t separator_length;
+  while (true) {
+    std::string_view pending(this->buffer.data() + this->start, this->end - this->start);
+    size_t crlf = pending.find("\r\n\r\n");
+    size_t lf = pending.find("\n\n");
+    if (crlf != std::string_view::npos || lf != std::string_view::npos) {
+      bool is_crlf = lf == std::string_view::npos || (crlf != std::string_view::npos && crlf < lf);
+      header_length = is_crlf ? crlf : lf;
+      separator_length = is_crlf ? 4 : 2;
+      break;
+    }
+
+    if (!this->fill()) {
+      return READ_CLOSED;
+    }
+  }
+
+  auto content_length = this->parse_headers(std::string_view(this->buffer.data() + this->start, header_length));
+  this->start += header_length + separator_length;
+  if (!content_length.has_value()) {
+    return READ_INVALID;
+  }
+
+  size_t length = content_length.value();
+  if (this->buffer.size() - this->start < length) {
+    memmove(this->buffer.data(), this->buffer.data() + this->start, this->end - this->start);
+    this->end -= this->start;
+    this->start = 0;
+    if (this->buffer.size() < length) {
+      this->buffer.resize(length);
+    }
+  }
+
+  while (this->end - this->start < length) {
+    if (!this->fill()) {
+      return READ_CLOSED;
+    }
+  }
+
+  this->body = std::string_view(this->buffer.data() + this->start, length);
+  this->start += length;
+  if (this->start == this->end) {
+    this->start = this->end = 0;
+  }
+
+  message = json::parse(this->body.begin(), this->body.end(), nullptr, false);
+  return message.is_discarded() ? READ_INVALID : READ_MESSAGE;
+}
+
+void Transport::write(const json& message, const std::function<void(std::string_view)>& on_written) {
+  std::lock_guard<std::mutex> lock(this->output_mutex);
+  this->output.clear();
+  dump_into(this->output, message);
+
+  this->write_frame(this->output);
+  if (on_written) {
+    on_written(this->output);
+  }
+}
+
+void Transport::write_response(const json& id, std::string_view result, const std::function<void(std::string_view)>& on_written) {
+  std::lock_guard<std::mutex> lock(this->output_mutex);
+  this->output.assign("{\"id\":");
+  dump_into(this->output, id);
+  this->output.append(",\"jsonrpc\":\"2.0\",\"result\":");
+  this->output.append(result);
+  this->output.push_back('}');
+
+  this->write_frame(this->output);
+  if (on_written) {
+    on_written(this->output);
+  }
+}
+
+// has to be called with output_mutex held
+void Transport::write_frame(std::string_view body) {
+  char header[64];
+  int header_length = snprintf(header, sizeof(header), "Content-Length: %zu\r\n\r\n", body.size());
+
+  struct iovec iov[2] = {
+    { .iov_base = header, .iov_len = (size_t)header_length },
+    { .iov_base = (void*)body.data(), .iov_len = body.size() },
+  };
+  struct iovec* pending = iov;
+  int count = 2;
+  while (count > 0) {
+    ssize_t len = ::writev(this->out_fd, pending, count);
+    if (len < 0 && errno == EINTR) {
+      continue;
+    }
+    if (len <= 0) {
+      break;
+    }
+
+    // a pipe that is full only takes part of it, pick up where it stopped
+    while (count > 0 && (size_t)len >= pending->iov_len) {
+      len -= pending->iov_len;
+      pending++;
+      count--;
+    }
+    if (count > 0) {
+      pending->iov_base = (char*)pending->iov_base + len;
+      pending->iov_len -= len;
+    }
+  }
+}
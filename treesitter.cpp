@@ -1,12 +1,83 @@
 #include "treesitter.hpp"
 
-std::string lsp::TreeSitter::get_node_str_from_points(TSNode n, std::string &line) {
+// feeds tree-sitter straight from the document pieces, without joining them into one string
+struct PieceReader {
+  const std::vector<lsp::Piece>* pieces;
+  size_t index;
+  size_t piece_start;
+};
+
+static const char* read_pieces(void* payload, uint32_t byte_index, TSPoint position, uint32_t* bytes_read) {
+  PieceReader* reader = (PieceReader*)payload;
+  if (byte_index < reader->piece_start) {
+    reader->index = 0;
+    reader->piece_start = 0;
+  }
+
+  while (reader->index < reader->pieces->size() &&
+      reader->piece_start + reader->pieces->at(reader->index).length <= byte_index) {
+    reader->piece_start += reader->pieces->at(reader->index).length;
+    reader->index++;
+  }
+
+  if (reader->index == reader->pieces->size()) {
+    *bytes_read = 0;
+    return "";
+  }
+
+  const lsp::Piece& piece = reader->pieces->at(reader->index);
+  size_t offset = byte_index - reader->piece_start;
+  *bytes_read = piece.length - offset;
+  return piece.buffer->data() + piece.offset + offset;
+}
+
+void lsp::TreeSitter::parse(Document& document) {
+  PieceReader reader = { .pieces = &document.get_pieces(), .index = 0, .piece_start = 0 };
+  TSInput input = {
+    .payload = &reader,
+    .read = read_pieces,
+    .encoding = TSInputEncodingUTF8,
+  };
+
+  // the old tree has already been edited, so only the changed regions are reparsed
+  TSTree* tree = ts_parser_parse(this->ts_parser, document.get_tree(), input);
+  if (tree == nullptr) {
+    ts_parser_reset(this->ts_parser);
+    return;
+  }
+  document.set_tree(tree);
+}
+
+// single lines are parsed from request workers, a parser can only be used by one thread at a time
+static TSParser* line_parser() {
+  struct ThreadParser {
+    TSParser* parser;
+    ThreadParser() {
+      this->parser = ts_parser_new();
+      ts_parser_set_language(this->parser, tree_sitter_javascript());
+    }
+    ~ThreadParser() {
+      ts_parser_delete(this->parser);
+    }
+  };
+
+  thread_local ThreadParser thread_parser;
+  return thread_parser.parser;
+}
+
+TSTree* lsp::parse_source(std::string_view source) {
+  TSParser* parser = line_parser();
+  ts_parser_reset(parser);
+  return ts_parser_parse_string(parser, nullptr, source.data(), source.size());
+}
+
+std::string lsp::TreeSitter::get_node_str_from_points(TSNode n, std::string_view line) {
   TSPoint start = ts_node_start_point(n); 
   TSPoint end = ts_node_end_point(n);
-  return line.substr(start.column, end.column - start.column);
+  return std::string(line.substr(start.column, end.column - start.column));
 }
 
-void lsp::TreeSitter::parse_object_toks(TSNode n, std::vector<std::string>& container, std::string& line) {
+void lsp::TreeSitter::parse_object_toks(TSNode n, std::vector<std::string>& container, std::string_view line) {
   std::string obj = "object";
   TSNode obj_n = ts_node_child_by_field_name(n, obj.c_str(), obj.size());
   if (std::string(ts_node_type(obj_n)) == "identifier") {
@@ -26,56 +97,44 @@ void lsp::TreeSitter::parse_object_toks(TSNode n, std::vector<std::string>& cont
   }
 }
 
-std::optional<lsp::RequireLineInfo> lsp::TreeSitter::parse_require_line(std::string require_line)  {
-  ts_parser_reset(this->ts_parser);
+std::optional<lsp::RequireLineInfo> lsp::TreeSitter::parse_require_line(std::string_view require_line)  {
+  const CompiledQuery& query = QueryRegistry::instance().get(QUERY_REQUIRE_LINE);
+  if (query.query == nullptr) {
+    return {};
+  }
+
+  TSParser* parser = line_parser();
+  ts_parser_reset(parser);
   RequireLineInfo req_info;
 
   TSTree* tree = ts_parser_parse_string(
-      this->ts_parser,
+      parser,
       nullptr,
-      require_line.c_str(),
+      require_line.data(),
       require_line.size());
 
   TSNode root = ts_tree_root_node(tree);
-  std::string query_str = "(variable_declarator name: (identifier) @required_vname value: (call_expression function: (identifier) arguments: (arguments (string(string_fragment) @cartridge_fpath))))";
-
-  uint32_t err_offset;
-  TSQueryError err_type;
-  TSQuery* query = ts_query_new(
-      tree_sitter_javascript(),
-      query_str.c_str(),
-      query_str.size(),
-      &err_offset,
-      &err_type);
-
-  if (err_type != TSQueryErrorNone) {
-    // @TODO: figure out how to report an error from line parsing. does it matter? 
-    return {};
-  }
 
-  TSQueryCursor* cursor = ts_query_cursor_new();
+  PooledCursor cursor;
   TSQueryMatch match = {0};
-  ts_query_cursor_exec(cursor, query, root);
+  ts_query_cursor_exec(cursor.get(), query.query, root);
 
   size_t match_count = 0 ;
-  while (ts_query_cursor_next_match(cursor, &match)) {
+  while (ts_query_cursor_next_match(cursor.get(), &match)) {
     match_count++;
-    if (match.capture_count > 0) {
-      for (size_t i = 0; i < match.capture_count; ++i) {
-        uint32_t len;
-        std::string capture_name = ts_query_capture_name_for_id(query, i, &len);
+    for (size_t i = 0; i < match.capture_count; ++i) {
+      if (match.captures[i].index == this->captures.cartridge_fpath) {
+        uint32_t start = ts_node_start_byte(match.captures[i].node);
+        uint32_t end = ts_node_end_byte(match.captures[i].node);
 
-        if (capture_name == "cartridge_fpath") {
-          TSPoint start_p = ts_node_start_point(match.captures[i].node);
-          TSPoint end_p = ts_node_end_point(match.captures[i].node);
-
-          req_info.cartridge_file_path = require_line.substr(start_p.column, end_p.column - start_p.column);
-          break;
-        }
+        req_info.cartridge_file_path = std::string(require_line.substr(start, end - start));
+        break;
       }
     }
   }
 
+  ts_tree_delete(tree);
+
   if (match_count == 0) {
     return {};
   }
@@ -84,88 +143,423 @@ std::optional<lsp::RequireLineInfo> lsp::TreeSitter::parse_require_line(std::str
 }
 
 
-std::optional<std::vector<std::string>> lsp::TreeSitter::parse_object_expansion(std::string line) {
-  ts_parser_reset(this->ts_parser);
-
-  TSTree* tree = ts_parser_parse_string(this->ts_parser, nullptr, line.c_str(), line.size());
-  TSNode root_node = ts_tree_root_node(tree);
-
-  std::string query_str = "(member_expression object: (identifier) property: (property_identifier)) @member_expr";
-  uint32_t err_offs;
-  TSQueryError err;
-  TSQuery* query = ts_query_new(tree_sitter_javascript(), query_str.c_str(), query_str.size(), &err_offs, &err);
-  if (err != TSQueryErrorNone) {
-    // @TODO: figure out how to report an error from line parsing. does it matter? 
+std::optional<std::vector<std::string>> lsp::TreeSitter::parse_object_expansion(std::string_view line) {
+  const CompiledQuery& query = QueryRegistry::instance().get(QUERY_MEMBER_EXPRESSION);
+  if (query.query == nullptr) {
     return {};
   }
 
-  TSQueryCursor* curs = ts_query_cursor_new();
-  ts_query_cursor_exec(curs, query, root_node);
+  TSParser* parser = line_parser();
+  ts_parser_reset(parser);
+
+  TSTree* tree = ts_parser_parse_string(parser, nullptr, line.data(), line.size());
+  TSNode root_node = ts_tree_root_node(tree);
+
+  PooledCursor curs;
+  ts_query_cursor_exec(curs.get(), query.query, root_node);
   TSQueryMatch m;
 
   uint32_t cap_idx;
-  if (!ts_query_cursor_next_capture(curs, &m, &cap_idx)) {
+  if (!ts_query_cursor_next_capture(curs.get(), &m, &cap_idx)) {
+    ts_tree_delete(tree);
     return {};
   }
 
   std::vector<std::string> tokens;
   parse_object_toks(m.captures[cap_idx].node, tokens, line);
+  ts_tree_delete(tree);
   return tokens;
 }
 
-std::optional<std::string> lsp::TreeSitter::get_variable_decl(std::string file_content, std::string var_name) {
-  std::vector<std::string> lines;
-  std::string buff;
-  std::stringstream ss(file_content);
-  while (std::getline(ss, buff, '\n')) {
-    lines.push_back(buff);
+// the path a `require('...')` call loads, nothing for any other value
+template <typename Text>
+static std::string require_target(Text text, TSNode declarator) {
+  TSNode value = ts_node_child_by_field_name(declarator, "value", 5);
+  if (ts_node_is_null(value) || std::string_view(ts_node_type(value)) != "call_expression") {
+    return "";
+  }
+
+  TSNode function = ts_node_child_by_field_name(value, "function", 8);
+  TSNode arguments = ts_node_child_by_field_name(value, "arguments", 9);
+  if (ts_node_is_null(function) || ts_node_is_null(arguments) || std::string_view(ts_node_type(function)) != "identifier" ||
+      text(ts_node_start_byte(function), ts_node_end_byte(function)) != "require") {
+    return "";
+  }
+
+  TSNode argument = ts_node_named_child(arguments, 0);
+  if (ts_node_is_null(argument) || std::string_view(ts_node_type(argument)) != "string") {
+    return "";
+  }
+  TSNode fragment = ts_node_named_child(argument, 0);
+  if (ts_node_is_null(fragment) || std::string_view(ts_node_type(fragment)) != "string_fragment") {
+    return "";
+  }
+  return text(ts_node_start_byte(fragment), ts_node_end_byte(fragment));
+}
+
+// `text(start, end)` gives the source between two byte offsets as a std::string
+template <typename Text>
+std::shared_ptr<const lsp::SymbolTable> lsp::TreeSitter::collect_symbols(const TSTree* tree, Text text) {
+  auto symbols = std::make_shared<SymbolTable>();
+  const CompiledQuery& query = QueryRegistry::instance().get(QUERY_VARIABLE_DECLARATION);
+  if (query.query == nullptr || tree == nullptr) {
+    return symbols;
   }
 
-  TSTree* tree = ts_parser_parse_string(this->ts_parser, nullptr, file_content.c_str(), file_content.size());
   TSNode root_node = ts_tree_root_node(tree);
 
-  std::string query_str = "(_ [ (variable_declaration (_ name: (identifier) @module_name)) @decl (lexical_declaration (_ name: (identifier) @module_name)) @decl ])";
-  uint32_t err_offs;
-  TSQueryError err;
-  TSQuery* query = ts_query_new(this->lang, query_str.c_str(), query_str.size(), &err_offs, &err);
-  if (err != TSQueryErrorNone) {
-    // @TODO: figure out how to report an error from line parsing. does it matter? 
-    return {};
+  PooledCursor curs;
+  ts_query_cursor_exec(curs.get(), query.query, root_node);
+  TSQueryMatch m;
+
+  while (ts_query_cursor_next_match(curs.get(), &m)) {
+    std::optional<TSNode> declarator = {};
+    std::optional<TSNode> name = {};
+    for (size_t i = 0; i < m.capture_count; ++i) {
+      if (m.captures[i].index == this->captures.declarator) {
+        declarator = m.captures[i].node;
+      } else if (m.captures[i].index == this->captures.name) {
+        name = m.captures[i].node;
+      }
+    }
+
+    if (!declarator.has_value() || !name.has_value()) {
+      continue;
+    }
+
+    // matches come in document order, a name declared again later keeps its first declaration
+    std::string key = text(ts_node_start_byte(name.value()), ts_node_end_byte(name.value()));
+    if (symbols->contains(key)) {
+      continue;
+    }
+    symbols->emplace(std::move(key), (Symbol) {
+        .start = ts_node_start_byte(declarator.value()),
+        .end = ts_node_end_byte(declarator.value()),
+        .name_start = ts_node_start_byte(name.value()),
+        .name_end = ts_node_end_byte(name.value()),
+        .require = require_target(text, declarator.value()),
+        });
+  }
+
+  return symbols;
+}
+
+std::shared_ptr<const lsp::SymbolTable> lsp::TreeSitter::build_symbols(const Document& document) {
+  return this->collect_symbols(document.get_tree(), [&document](size_t start, size_t end) {
+      return document.text(start, end);
+      });
+}
+
+std::shared_ptr<const lsp::SymbolTable> lsp::TreeSitter::build_symbols(const ParsedFile& file) {
+  return this->collect_symbols(file.tree, [&file](size_t start, size_t end) {
+      return file.source.substr(start, end - start);
+      });
+}
+
+static std::string_view node_text(const std::string& source, TSNode node) {
+  return std::string_view(source).substr(ts_node_start_byte(node), ts_node_end_byte(node) - ts_node_start_byte(node));
+}
+
+static bool is_identifier(TSNode node) {
+  if (ts_node_is_null(node)) {
+    return false;
+  }
+  std::string_view type = ts_node_type(node);
+  return type == "identifier" || type == "shorthand_property_identifier";
+}
+
+// the client counts columns in utf-16 units, nodes spanning lines have no single line range
+static bool utf16_columns(const std::string& source, TSNode node, uint32_t& start_column, uint32_t& end_column) {
+  TSPoint start = ts_node_start_point(node);
+  TSPoint end = ts_node_end_point(node);
+  if (start.row != end.row) {
+    return false;
+  }
+
+  std::string_view line = std::string_view(source).substr(ts_node_start_byte(node) - start.column, end.column);
+  start_column = (uint32_t)lsp::utf16_length(line.substr(0, start.column));
+  end_column = (uint32_t)lsp::utf16_length(line);
+  return true;
+}
+
+// `value` is what was assigned, an identifier is remembered in `values` to be resolved once all exports are known
+static void add_export(lsp::ModuleExports& exports, std::vector<std::pair<std::string, std::string_view>>& values,
+    const std::string& source, TSNode name, TSNode value) {
+  uint32_t start, end;
+  if (!utf16_columns(source, name, start, end)) {
+    return;
   }
 
-  TSQueryCursor* curs = ts_query_cursor_new();
-  ts_query_cursor_exec(curs, query, root_node);
+  auto [it, inserted] = exports.try_emplace(std::string(node_text(source, name)), (lsp::Export) {
+      .line = ts_node_start_point(name).row,
+      .start = start,
+      .end = end,
+      .target_line = ts_node_start_point(name).row,
+      .target_start = start,
+      .target_end = end,
+      });
+  if (inserted && is_identifier(value)) {
+    values.push_back({it->first, node_text(source, value)});
+  }
+}
+
+lsp::ModuleExports lsp::TreeSitter::exports_of(const TSTree* tree, const std::string& source) {
+  ModuleExports exports;
+  std::vector<std::pair<std::string, std::string_view>> values;
+  const CompiledQuery& query = QueryRegistry::instance().get(QUERY_EXPORT_ASSIGNMENT);
+  if (query.query == nullptr) {
+    return exports;
+  }
+
+  PooledCursor curs;
+  ts_query_cursor_exec(curs.get(), query.query, ts_tree_root_node(tree));
   TSQueryMatch m;
 
-  std::optional<TSNode> lex_decl = {};
-  while (ts_query_cursor_next_match(curs, &m)) {
-    if (m.capture_count < 0) {
-      break;
+  while (ts_query_cursor_next_match(curs.get(), &m)) {
+    std::optional<TSNode> left = {};
+    std::optional<TSNode> right = {};
+    for (size_t i = 0; i < m.capture_count; ++i) {
+      if (m.captures[i].index == this->captures.export_left) {
+        left = m.captures[i].node;
+      } else if (m.captures[i].index == this->captures.export_right) {
+        right = m.captures[i].node;
+      }
+    }
+
+    if (!left.has_value() || !right.has_value()) {
+      continue;
     }
 
-    uint32_t len;
-    // lex_decl capture
-    auto idx = m.captures[0].index;
-    std::string first_capture = ts_query_capture_name_for_id(query, idx, &len);
+    TSNode object = ts_node_child_by_field_name(left.value(), "object", 6);
+    TSNode property = ts_node_child_by_field_name(left.value(), "property", 8);
+    if (ts_node_is_null(object) || ts_node_is_null(property)) {
+      continue;
+    }
+    std::string_view object_text = node_text(source, object);
 
-    // module_name capture
-    idx = m.captures[1].index;
-    std::string second_capture = ts_query_capture_name_for_id(query, idx, &len);
+    // `exports.x = ...` and `module.exports.x = ...`
+    if (object_text == "exports" || object_text == "module.exports") {
+      add_export(exports, values, source, property, right.value());
+      continue;
+    }
+
+    // `module.exports = { x: ..., y, z() {} }`
+    if (object_text != "module" || node_text(source, property) != "exports" || std::string_view(ts_node_type(right.value())) != "object") {
+      continue;
+    }
+    for (uint32_t i = 0; i < ts_node_named_child_count(right.value()); ++i) {
+      TSNode member = ts_node_named_child(right.value(), i);
+      std::string_view type = ts_node_type(member);
+      if (type == "shorthand_property_identifier") {
+        // `{ x }` exports the variable x
+        add_export(exports, values, source, member, member);
+        continue;
+      }
+
+      TSNode name = ts_node_child_by_field_name(member, type == "pair" ? "key" : "name", type == "pair" ? 3 : 4);
+      if ((type != "pair" && type != "method_definition") || ts_node_is_null(name)) {
+        continue;
+      }
+      // quoted keys point at the text inside of the quotes
+      if (std::string_view(ts_node_type(name)) == "string") {
+        name = ts_node_named_child(name, 0);
+        if (ts_node_is_null(name)) {
+          continue;
+        }
+      }
+      add_export(exports, values, source, name, type == "pair" ? ts_node_child_by_field_name(member, "value", 5) : TSNode {});
+    }
+  }
 
-    TSPoint start = ts_node_start_point(m.captures[1].node);
-    TSPoint end = ts_node_end_point(m.captures[1].node);
+  if (values.empty()) {
+    return exports;
+  }
 
-    if (lines[start.row].substr(start.column, end.column - start.column) == var_name) {
-      lex_decl = m.captures[0].node;
-      break;
+  // the same first declarations a definition in an open document would land on
+  auto symbols = this->collect_symbols(tree, [&source](size_t start, size_t end) {
+      return source.substr(start, end - start);
+      });
+  TSNode root = ts_tree_root_node(tree);
+  for (const auto& [exported, value] : values) {
+    auto symbol = symbols->find(std::string(value));
+    if (symbol == symbols->end()) {
+      continue;
+    }
+    TSNode declared = ts_node_descendant_for_byte_range(root, symbol->second.name_start, symbol->second.name_end);
+    uint32_t start, end;
+    if (ts_node_is_null(declared) || !utf16_columns(source, declared, start, end)) {
+      continue;
     }
+    Export& target = exports.at(exported);
+    target.target_line = ts_node_start_point(declared).row;
+    target.target_start = start;
+    target.target_end = end;
   }
 
-  if (lex_decl.has_value()) {
-    TSPoint start = ts_node_start_point(lex_decl.value());
-    TSPoint end = ts_node_end_point(lex_decl.value());
-    return lines[start.row].substr(start.column, end.column - start.column);
+  return exports;
+}
+
+static void add_member_use(lsp::RequireSite& site, const std::string& source, TSNode name) {
+  uint32_t start, end;
+  if (ts_node_is_null(name) || !utf16_columns(source, name, start, end)) {
+    return;
+  }
+  site.members.push_back((lsp::MemberUse) {
+      .name = std::string(node_text(source, name)),
+      .line = ts_node_start_point(name).row,
+      .start = start,
+      .end = end,
+      });
+}
+
+std::vector<lsp::RequireSite> lsp::TreeSitter::requires_of(const TSTree* tree, const std::string& source) {
+  std::vector<RequireSite> sites;
+  const CompiledQuery& query = QueryRegistry::instance().get(QUERY_REQUIRE_CALL);
+  if (query.query == nullptr) {
+    return sites;
+  }
+
+  // variable name -> index of the require it holds. scopes are not tracked, a later declaration wins
+  std::unordered_map<std::string_view, size_t> bindings;
+  {
+    PooledCursor curs;
+    ts_query_cursor_exec(curs.get(), query.query, ts_tree_root_node(tree));
+    TSQueryMatch m;
+
+    while (ts_query_cursor_next_match(curs.get(), &m)) {
+      std::optional<TSNode> function = {};
+      std::optional<TSNode> path = {};
+      std::optional<TSNode> call = {};
+      for (size_t i = 0; i < m.capture_count; ++i) {
+        if (m.captures[i].index == this->captures.require_function) {
+          function = m.captures[i].node;
+        } else if (m.captures[i].index == this->captures.require_path) {
+          path = m.captures[i].node;
+        } else if (m.captures[i].index == this->captures.require_call) {
+          call = m.captures[i].node;
+        }
+      }
+
+      uint32_t start, end;
+      if (!function.has_value() || !path.has_value() || !call.has_value() || node_text(source, function.value()) != "require" || !utf16_columns(source, path.value(), start, end)) {
+        continue;
+      }
+
+      sites.push_back((RequireSite) {
+          .specifier = std::string(node_text(source, path.value())),
+          .line = ts_node_start_point(path.value()).row,
+          .start = start,
+          .end = end,
+          .members = {},
+          });
+      RequireSite& site = sites.back();
+
+      TSNode parent = ts_node_parent(call.value());
+      std::string_view parent_type = ts_node_is_null(parent) ? "" : ts_node_type(parent);
+      if (parent_type == "member_expression") {
+        // `require('...').calc`
+        add_member_use(site, source, ts_node_child_by_field_name(parent, "property", 8));
+        continue;
+      }
+      if (parent_type != "variable_declarator") {
+        continue;
+      }
+
+      TSNode name = ts_node_child_by_field_name(parent, "name", 4);
+      std::string_view name_type = ts_node_is_null(name) ? "" : ts_node_type(name);
+      if (name_type == "identifier") {
+        bindings[node_text(source, name)] = sites.size() - 1;
+      } else if (name_type == "object_pattern") {
+        // `var { calc, total: sum } = require('...')`
+        for (uint32_t i = 0; i < ts_node_named_child_count(name); ++i) {
+          TSNode property = ts_node_named_child(name, i);
+          std::string_view type = ts_node_type(property);
+          if (type == "shorthand_property_identifier_pattern") {
+            add_member_use(site, source, property);
+          } else if (type == "pair_pattern") {
+            add_member_use(site, source, ts_node_child_by_field_name(property, "key", 3));
+          }
+        }
+      }
+    }
+  }
+
+  const CompiledQuery& members = QueryRegistry::instance().get(QUERY_MEMBER_EXPRESSION);
+  if (bindings.empty() || members.query == nullptr) {
+    return sites;
+  }
+
+  PooledCursor curs;
+  ts_query_cursor_exec(curs.get(), members.query, ts_tree_root_node(tree));
+  TSQueryMatch m;
+  while (ts_query_cursor_next_match(curs.get(), &m)) {
+    for (size_t i = 0; i < m.capture_count; ++i) {
+      if (m.captures[i].index != this->captures.member_expression) {
+        continue;
+      }
+      TSNode object = ts_node_child_by_field_name(m.captures[i].node, "object", 6);
+      auto binding = bindings.find(node_text(source, object));
+      if (binding != bindings.end()) {
+        add_member_use(sites[binding->second], source, ts_node_child_by_field_name(m.captures[i].node, "property", 8));
+      }
+    }
+  }
+
+  return sites;
+}
+
+std::vector<lsp::Declaration> lsp::TreeSitter::declarations_of(const TSTree* tree, const std::string& source) {
+  std::vector<Declaration> declarations;
+  const CompiledQuery& query = QueryRegistry::instance().get(QUERY_VARIABLE_DECLARATION);
+  if (query.query == nullptr) {
+    return declarations;
+  }
+
+  auto text = [&source](size_t start, size_t end) { return source.substr(start, end - start); };
+  PooledCursor curs;
+  ts_query_cursor_exec(curs.get(), query.query, ts_tree_root_node(tree));
+  TSQueryMatch m;
+
+  while (ts_query_cursor_next_match(curs.get(), &m)) {
+    std::optional<TSNode> declarator = {};
+    std::optional<TSNode> name = {};
+    for (size_t i = 0; i < m.capture_count; ++i) {
+      if (m.captures[i].index == this->captures.declarator) {
+        declarator = m.captures[i].node;
+      } else if (m.captures[i].index == this->captures.name) {
+        name = m.captures[i].node;
+      }
+    }
+
+    uint32_t start, end;
+    if (!declarator.has_value() || !name.has_value() || !utf16_columns(source, name.value(), start, end)) {
+      continue;
+    }
+
+    int kind = SYMBOL_KIND_FUNCTION;
+    if (std::string_view(ts_node_type(declarator.value())) == "variable_declarator") {
+      // locals of every function would bury everything else
+      TSNode declaration = ts_node_parent(declarator.value());
+      TSNode scope = ts_node_is_null(declaration) ? declaration : ts_node_parent(declaration);
+      if (ts_node_is_null(scope) || std::string_view(ts_node_type(scope)) != "program" || !require_target(text, declarator.value()).empty()) {
+        continue;
+      }
+
+      TSNode value = ts_node_child_by_field_name(declarator.value(), "value", 5);
+      std::string_view value_type = ts_node_is_null(value) ? "" : ts_node_type(value);
+      if (value_type != "function_expression" && value_type != "function" && value_type != "arrow_function" && value_type != "generator_function") {
+        kind = SYMBOL_KIND_VARIABLE;
+      }
+    }
+
+    declarations.push_back((Declaration) {
+        .name = std::string(node_text(source, name.value())),
+        .kind = kind,
+        .line = ts_node_start_point(name.value()).row,
+        .start = start,
+        .end = end,
+        });
   }
 
-  return {};
+  return declarations;
 }
@@ -0,0 +1,263 @@
+#include "watcher.hpp"
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+using namespace lsp;
+
+// a batch is flushed once no event came in for QUIET_PERIOD, but never later than MAX_DELAY after its first event
+static const std::chrono::milliseconds QUIET_PERIOD(100);
+static const std::chrono::milliseconds MAX_DELAY(1000);
+static const uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_ONLYDIR;
+
+Watcher::~Watcher() {
+  this->stopping = true;
+  if (this->wake_fd >= 0) {
+    uint64_t one = 1;
+    write(this->wake_fd, &one, sizeof(one));
+  }
+
+  if (this->thread.joinable()) {
+    this->thread.join();
+  }
+
+  if (this->inotify_fd >= 0) {
+    close(this->inotify_fd);
+  }
+  if (this->wake_fd >= 0) {
+    close(this->wake_fd);
+  }
+}
+
+bool Watcher::start() {
+  this->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  this->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  this->thread = std::thread(&Watcher::run, this);
+  return this->inotify_fd >= 0;
+}
+
+void Watcher::watch(const std::vector<DirectoryStamp>& directories) {
+  bool changed = false;
+  for (const auto& directory : directories) {
+    this->add_watch(directory.path);
+
+    // anything that changed between the walk and the watch being added would otherwise go unnoticed
+    auto mtime = directory_mtime(directory.path);
+    if (!mtime.has_value() || mtime.value() != directory.mtime) {
+      changed = true;
+    }
+  }
+
+  if (changed) {
+    this->queue((FileEvent) { .path = "", .type = FILE_RESCAN, .is_directory = true });
+  }
+}
+
+void Watcher::add_watch(const std::string& path) {
+  if (this->inotify_fd < 0 || this->watch_limit_reached) {
+    return;
+  }
+
+  int wd = inotify_add_watch(this->inotify_fd, path.c_str(), WATCH_MASK);
+  if (wd < 0) {
+    if (errno == ENOSPC && !this->watch_limit_reached.exchange(true) && this->on_limit) {
+      this->on_limit();
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->watches_mutex);
+  this->watches[wd] = path;
+}
+
+void Watcher::remove_watches(const std::string& path) {
+  std::lock_guard<std::mutex> lock(this->watches_mutex);
+  for (auto it = this->watches.begin(); it != this->watches.end();) {
+    if (it->second == path || it->second.starts_with(path + "/")) {
+      inotify_rm_watch(this->inotify_fd, it->first);
+      it = this->watches.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// a directory that appears brings its whole content along without any events for it
+void Watcher::add_directory(const std::string& path) {
+  if (is_forbidden_path(path)) {
+    return;
+  }
+
+  this->add_watch(path);
+  this->queue((FileEvent) { .path = path, .type = FILE_CREATED, .is_directory = true });
+
+  std::error_code ec;
+  std::filesystem::directory_iterator it(path, ec);
+  for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+    std::error_code type_ec;
+    if (it->is_directory(type_ec)) {
+      this->add_directory(it->path().string());
+    } else {
+      this->queue((FileEvent) { .path = it->path().string(), .type = FILE_CREATED, .is_directory = false });
+    }
+  }
+}
+
+void Watcher::add_events(std::vector<FileEvent> events) {
+  for (auto& event : events) {
+    std::error_code ec;
+    if (event.type == FILE_CREATED && std::filesystem::is_directory(event.path, ec)) {
+      this->add_directory(event.path);
+      continue;
+    }
+    this->queue(std::move(event));
+  }
+
+  // poll might be sleeping without a timeout
+  if (this->wake_fd >= 0) {
+    uint64_t one = 1;
+    write(this->wake_fd, &one, sizeof(one));
+  }
+}
+
+void Watcher::queue(FileEvent event) {
+  std::lock_guard<std::mutex> lock(this->pending_mutex);
+  auto now = std::chrono::steady_clock::now();
+  if (this->pending.empty()) {
+    this->first_pending = now;
+  }
+  this->last_pending = now;
+
+  auto existing = this->pending.find(event.path);
+  if (existing == this->pending.end()) {
+    this->pending.insert({event.path, std::move(event)});
+    return;
+  }
+
+  // only the final state of a path matters, except that a write does not hide its creation
+  if (event.type == FILE_CHANGED && existing->second.type == FILE_CREATED) {
+    return;
+  }
+  existing->second = std::move(event);
+}
+
+bool Watcher::flush_due() {
+  std::lock_guard<std::mutex> lock(this->pending_mutex);
+  if (this->pending.empty()) {
+    return false;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  return now - this->last_pending >= QUIET_PERIOD || now - this->first_pending >= MAX_DELAY;
+}
+
+void Watcher::flush() {
+  std::vector<FileEvent> batch;
+  {
+    std::lock_guard<std::mutex> lock(this->pending_mutex);
+    batch.reserve(this->pending.size());
+    for (auto& [path, event] : this->pending) {
+      batch.push_back(std::move(event));
+    }
+    this->pending.clear();
+  }
+
+  if (!batch.empty()) {
+    this->on_batch(std::move(batch));
+  }
+}
+
+void Watcher::read_events() {
+  alignas(struct inotify_event) char buffer[64 * 1024];
+
+  while (true) {
+    ssize_t len = read(this->inotify_fd, buffer, sizeof(buffer));
+    if (len <= 0) {
+      return;
+    }
+
+    for (char* ptr = buffer; ptr < buffer + len;) {
+      const struct inotify_event* event = (const struct inotify_event*)ptr;
+      ptr += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        this->queue((FileEvent) { .path = "", .type = FILE_RESCAN, .is_directory = true });
+        continue;
+      }
+
+      std::string path;
+      {
+        std::lock_guard<std::mutex> lock(this->watches_mutex);
+        auto watch = this->watches.find(event->wd);
+        if (watch == this->watches.end()) {
+          continue;
+        }
+
+        if (event->mask & IN_IGNORED) {
+          this->watches.erase(watch);
+          continue;
+        }
+        path = watch->second;
+      }
+
+      if (event->len > 0) {
+        path.append("/");
+        path.append(event->name);
+      }
+
+      bool is_directory = event->mask & IN_ISDIR;
+      if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+        if (is_directory) {
+          this->add_directory(path);
+        } else {
+          this->queue((FileEvent) { .path = path, .type = FILE_CREATED, .is_directory = false });
+        }
+      } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+        if (is_directory) {
+          this->remove_watches(path);
+        }
+        this->queue((FileEvent) { .path = path, .type = FILE_DELETED, .is_directory = is_directory });
+      } else if (event->mask & IN_CLOSE_WRITE) {
+        this->queue((FileEvent) { .path = path, .type = FILE_CHANGED, .is_directory = false });
+      }
+    }
+  }
+}
+
+void Watcher::run() {
+  while (!this->stopping) {
+    int timeout = -1;
+    {
+      std::lock_guard<std::mutex> lock(this->pending_mutex);
+      if (!this->pending.empty()) {
+        auto now = std::chrono::steady_clock::now();
+        auto due = std::min(this->last_pending + QUIET_PERIOD, this->first_pending + MAX_DELAY);
+        timeout = std::max((int)std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count(), 0);
+      }
+    }
+
+    struct pollfd fds[2] = {
+      { .fd = this->wake_fd, .events = POLLIN, .revents = 0 },
+      { .fd = this->inotify_fd, .events = POLLIN, .revents = 0 },
+    };
+    poll(fds, this->inotify_fd >= 0 ? 2 : 1, timeout);
+
+    if (fds[0].revents & POLLIN) {
+      uint64_t value;
+      read(this->wake_fd, &value, sizeof(value));
+    }
+
+    if (this->stopping) {
+      return;
+    }
+
+    if (this->inotify_fd >= 0 && (fds[1].revents & POLLIN)) {
+      this->read_events();
+    }
+
+    if (this->flush_due()) {
+      this->flush();
+    }
+  }
+}